@@ -0,0 +1,100 @@
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include <structurator/arena.hpp>
+#include <structurator/json_parser.hpp>
+#include <structurator/arena_objects.hpp>
+#include <structurator/object_mapper.hpp>
+
+#include "bench_utilities.hpp"
+
+/// Compares reading and freeing a tree of polymorphic objects built from std::unique_ptr, std::vector and std::string
+/// with the same tree built from arena_ptr, arena_vector and arena_string, which is freed by one arena::reset().
+
+struct shape
+{
+    virtual ~shape() = default;
+};
+
+struct circle : shape
+{
+    double radius = 0.0;
+    stc_declare_class(circle, radius);
+};
+
+struct rectangle : shape
+{
+    double width = 0.0;
+    double height = 0.0;
+    stc_declare_class(rectangle, width, height);
+};
+
+struct heap_node
+{
+    std::string name;
+    std::unique_ptr<shape> item;
+    std::vector<heap_node> children;
+    stc_declare_class(heap_node, name,
+        (item, stc::member_alts("kind", stc::alt_mode::nest, stc::alt<std::unique_ptr<circle>>("circle"), stc::alt<std::unique_ptr<rectangle>>("rectangle"))),
+        children);
+};
+
+/// Shapes derive from a polymorphic base, so their destructors are still called by the arena.
+struct arena_node
+{
+    stc::arena_string name;
+    stc::arena_ptr<shape> item;
+    stc::arena_vector<arena_node> children;
+    stc_declare_class(arena_node, name,
+        (item, stc::member_alts("kind", stc::alt_mode::nest, stc::alt<stc::arena_ptr<circle>>("circle"), stc::alt<stc::arena_ptr<rectangle>>("rectangle"))),
+        children);
+};
+
+/// Tree with \p fanout children per node down to \p depth levels.
+static void append_node(std::string &json, size_t depth, size_t fanout, size_t &counter)
+{
+    size_t id = counter++;
+    json += "{ \"name\": \"node number " + std::to_string(id) + "\", ";
+    json += id % 2 == 0 ? "\"kind\": \"circle\", \"item\": { \"radius\": 1.5 }" : "\"kind\": \"rectangle\", \"item\": { \"width\": 2, \"height\": 0.5 }";
+    json += ", \"children\": [";
+    for(size_t i = 0; depth > 0 && i < fanout; ++i)
+    {
+        json += i == 0 ? " " : ", ";
+        append_node(json, depth - 1, fanout, counter);
+    }
+
+    json += " ] }";
+}
+
+int main(int argc, char **argv)
+{
+    size_t depth = argc > 1 ? size_t(std::strtoull(argv[1], nullptr, 10)) : 7;
+    size_t nodes = 0;
+    std::string json;
+    append_node(json, depth, 5, nodes);
+
+    auto on_parse_error = [](const stc::json::parse_error&) { std::abort(); };
+    auto on_consume_error = [](const stc::doc_error&) { std::abort(); };
+
+    std::printf("document: %zu nodes, %zu bytes\n", nodes, json.size());
+
+    double heap_time = bench::measure("heap tree, read and freed", json.size(), [&]
+    {
+        auto result = stc::json::from_json<heap_node>(json, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    stc::arena storage;
+    double arena_time = bench::measure("arena tree, read and reset", json.size(), [&]
+    {
+        stc::doc_context context{ on_consume_error, false, nullptr, &storage };
+        auto result = stc::json::from_json_with_context<arena_node>(json, on_parse_error, context);
+        bench::keep(result);
+        storage.reset();
+    });
+
+    std::printf("speedup: %.2fx\n", heap_time / arena_time);
+}
\ No newline at end of file
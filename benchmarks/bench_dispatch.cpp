@@ -0,0 +1,88 @@
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+
+#include <structurator/json_input.hpp>
+#include <structurator/json_parser.hpp>
+#include <structurator/object_mapper.hpp>
+
+#include "bench_utilities.hpp"
+
+/// Compares reading the same document through the virtual doc_input interface (json::input() + from_input())
+/// with the statically dispatched parser (json::from_json()) and with reading into the result of the previous run
+/// (json::from_json_into()).
+
+struct point
+{
+    double x;
+    double y;
+    stc_declare_class(point, x, y);
+};
+
+struct feature
+{
+    int id;
+    std::string name;
+    bool visible;
+    std::vector<point> outline;
+    std::map<std::string, int> tags;
+    stc_declare_class(feature, id, name, visible, outline, tags);
+};
+
+/// Document with many small tokens, so the cost per token dominates.
+static std::string make_document(size_t features)
+{
+    std::string json = "[";
+    for(size_t i = 0; i < features; ++i)
+    {
+        json += i == 0 ? "\n" : ",\n";
+        json += "  { \"id\": " + std::to_string(i) + ", \"name\": \"feature " + std::to_string(i) + "\", \"visible\": ";
+        json += i % 3 == 0 ? "false" : "true";
+        json += ", \"outline\": [";
+        for(size_t p = 0; p < 8; ++p)
+            json += (p == 0 ? "" : ", ") + std::string("{ \"x\": ") + std::to_string(p * 1.5 + i) + ", \"y\": -" + std::to_string(p) + ".25 }";
+
+        json += "], \"tags\": { \"kind\": " + std::to_string(i % 7) + ", \"layer\": " + std::to_string(i % 4) + " } }";
+    }
+
+    return json + "\n]\n";
+}
+
+int main(int argc, char **argv)
+{
+    size_t features = argc > 1 ? size_t(std::strtoull(argv[1], nullptr, 10)) : 20000;
+    std::string json = make_document(features);
+
+    auto on_parse_error = [](const stc::json::parse_error&) { std::abort(); };
+    auto on_consume_error = [](const stc::doc_error&) { std::abort(); };
+
+    std::printf("document: %zu features, %zu bytes\n", features, json.size());
+
+    double virtual_time = bench::measure("virtual doc_input", json.size(), [&]
+    {
+        std::unique_ptr<stc::doc_input> input = stc::json::input(json, on_parse_error);
+        auto result = stc::from_input<std::vector<feature>>(*input, on_consume_error);
+        bench::keep(result);
+    });
+
+    double static_time = bench::measure("static json::from_json", json.size(), [&]
+    {
+        auto result = stc::json::from_json<std::vector<feature>>(json, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    std::printf("speedup: %.2fx\n", virtual_time / static_time);
+
+    std::vector<feature> reused;
+    double into_time = bench::measure("json::from_json_into", json.size(), [&]
+    {
+        bool result = stc::json::from_json_into(reused, json, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    std::printf("speedup of reusing the result: %.2fx\n", static_time / into_time);
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include <structurator/json_push.hpp>
+#include <structurator/json_lines.hpp>
+#include <structurator/json_parser.hpp>
+#include <structurator/json_documents.hpp>
+#include <structurator/object_mapper.hpp>
+
+#include "bench_utilities.hpp"
+
+/// Compares reading newline-delimited log records with one from_json() per line to lines_reader, document_stream
+/// and push_parser, which receives the document in fragments of the size of TCP segments.
+
+struct log_record
+{
+    long long time;
+    std::string level;
+    std::string message;
+    std::vector<int> codes;
+    stc_declare_class(log_record, time, level, message, codes);
+};
+
+static std::string make_document(size_t records)
+{
+    static const char *levels[] = { "debug", "info", "warning", "error" };
+
+    std::string json;
+    for(size_t i = 0; i < records; ++i)
+    {
+        json += "{\"time\":" + std::to_string(1700000000000 + i * 17) + ",\"level\":\"" + levels[i % 4] +
+            "\",\"message\":\"request " + std::to_string(i) + " served in \\\"" + std::to_string(i % 250) + " ms\\\"\",\"codes\":[" +
+            std::to_string(200 + i % 5) + "," + std::to_string(i % 13) + "]}\n";
+    }
+
+    return json;
+}
+
+int main(int argc, char **argv)
+{
+    size_t records = argc > 1 ? size_t(std::strtoull(argv[1], nullptr, 10)) : 300000;
+    std::string json = make_document(records);
+
+    auto on_parse_error = [](const stc::json::parse_error&) { std::abort(); };
+    auto on_consume_error = [](const stc::doc_error&) { std::abort(); };
+
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::printf("document: %zu lines, %zu bytes, %u hardware threads\n", records, json.size(), threads);
+
+    double serial_time = bench::measure("from_json per line", json.size(), [&]
+    {
+        size_t count = 0;
+        for(size_t begin = 0; begin < json.size();)
+        {
+            size_t end = json.find('\n', begin);
+            auto result = stc::json::from_json<log_record>(std::string_view(json).substr(begin, end - begin), on_parse_error, on_consume_error);
+            count += result.has_value();
+            begin = end + 1;
+        }
+
+        bench::keep(count);
+    });
+
+    bench::measure("document_stream", json.size(), [&]
+    {
+        size_t count = 0;
+        for(std::optional<log_record> &record : stc::json::document_stream<log_record>(json, on_parse_error, on_consume_error))
+            count += record.has_value();
+
+        bench::keep(count);
+    });
+
+    bench::measure("push_parser, 1460 byte fragments", json.size(), [&]
+    {
+        size_t count = 0;
+        stc::json::push_parser<log_record> push([&](std::optional<log_record> &&record) { count += record.has_value(); }, on_parse_error, on_consume_error);
+        for(size_t pos = 0; pos < json.size(); pos += 1460)
+            push.feed(std::string_view(json).substr(pos, 1460));
+
+        push.finish();
+        bench::keep(count);
+    });
+
+    auto read_lines = [&](unsigned workers, bool ordered)
+    {
+        stc::json::lines_options options;
+        options.threads = workers;
+        options.ordered = ordered;
+
+        size_t count = stc::json::read_json_lines<log_record>(json, [](log_record &&record, unsigned) { bench::keep(record); }, on_parse_error, on_consume_error, options);
+        bench::keep(count);
+    };
+
+    bench::measure("lines_reader, calling thread", json.size(), [&] { read_lines(1, true); });
+    double ordered_time = bench::measure("lines_reader, ordered", json.size(), [&] { read_lines(threads, true); });
+    bench::measure("lines_reader, unordered", json.size(), [&] { read_lines(threads, false); });
+    bench::measure("lines_reader, 4 threads", json.size(), [&] { read_lines(4, true); });
+
+    std::printf("speedup: %.2fx\n", serial_time / ordered_time);
+}
@@ -0,0 +1,102 @@
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <random>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+#include <structurator/json_input.hpp>
+#include <structurator/json_parser.hpp>
+#include <structurator/object_mapper.hpp>
+
+#include "bench_utilities.hpp"
+
+/// Measures reading arrays of integers and floating-point numbers, where converting numbers dominates.
+
+/// Array of \p count numbers, each generated from its index by \p fn.
+template<class Fn>
+static std::string make_document(size_t count, Fn &&fn)
+{
+    std::string json = "[";
+    for(size_t i = 0; i < count; ++i)
+        json += (i == 0 ? "" : ",") + fn(i);
+
+    return json + "]";
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = argc > 1 ? size_t(std::strtoull(argv[1], nullptr, 10)) : 500000;
+
+    auto on_parse_error = [](const stc::json::parse_error&) { std::abort(); };
+    auto on_consume_error = [](const stc::doc_error&) { std::abort(); };
+
+    std::string integers = make_document(count, [](size_t i) { return std::to_string(i * 2654435761u % 100000000000ull); });
+    std::string decimals = make_document(count, [](size_t i) { return std::to_string(i % 1000) + "." + std::to_string(i * 7919 % 1000000); });
+    std::string exponents = make_document(count, [](size_t i) { return std::to_string(i % 100000) + ".25e-" + std::to_string(i % 20); });
+
+    std::string points = make_document(count / 3, [](size_t i) //short arrays of coordinates, like in GeoJSON
+    {
+        return "[" + std::to_string(i % 360) + ".5, " + std::to_string(i % 90) + ".25, " + std::to_string(i % 1000) + "]";
+    });
+
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> mantissas(1.0, 10.0);
+    std::string shortest = make_document(count, [&](size_t i) //as printed by serializers, with up to 17 digits
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.17ge%d", mantissas(random), int(i % 600) - 300);
+        return std::string(buffer);
+    });
+
+    bench::measure("std::int64_t", integers.size(), [&]
+    {
+        auto result = stc::json::from_json<std::vector<std::int64_t>>(integers, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    bench::measure("std::int64_t, through doc_input", integers.size(), [&] //generic loop instead of the parser's
+    {
+        auto input = stc::json::input(integers, on_parse_error);
+        auto result = stc::from_input<std::vector<std::int64_t>>(*input, on_consume_error);
+        bench::keep(result);
+    });
+
+    bench::measure("double, fixed-point", decimals.size(), [&]
+    {
+        auto result = stc::json::from_json<std::vector<double>>(decimals, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    bench::measure("double, with exponent", exponents.size(), [&]
+    {
+        auto result = stc::json::from_json<std::vector<double>>(exponents, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    bench::measure("double, 17 digits, wide range", shortest.size(), [&]
+    {
+        auto result = stc::json::from_json<std::vector<double>>(shortest, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    bench::measure("float, fixed-point", decimals.size(), [&]
+    {
+        auto result = stc::json::from_json<std::vector<float>>(decimals, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    bench::measure("long double, fixed-point", decimals.size(), [&]
+    {
+        auto result = stc::json::from_json<std::vector<long double>>(decimals, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    bench::measure("std::array<float, 3>", points.size(), [&]
+    {
+        auto result = stc::json::from_json<std::vector<std::array<float, 3>>>(points, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include <structurator/json_parser.hpp>
+#include <structurator/json_parallel.hpp>
+#include <structurator/object_mapper.hpp>
+
+#include "bench_utilities.hpp"
+
+/// Compares reading one large array of records serially with from_json_parallel().
+
+struct record
+{
+    int id;
+    std::string name;
+    std::vector<double> values;
+    bool active;
+    stc_declare_class(record, id, name, values, active);
+};
+
+static std::string make_document(size_t records)
+{
+    std::string json = "[";
+    for(size_t i = 0; i < records; ++i)
+    {
+        json += i == 0 ? "\n" : ",\n";
+        json += "  { \"id\": " + std::to_string(i) + ", \"name\": \"record, \\\"" + std::to_string(i) + "\\\" [a]\", \"values\": [";
+        for(size_t v = 0; v < 8; ++v)
+            json += (v == 0 ? "" : ", ") + std::to_string(v * 31 + i) + ".5";
+
+        json += std::string("], \"active\": ") + (i % 3 == 0 ? "true" : "false") + " }";
+    }
+
+    return json + "\n]\n";
+}
+
+int main(int argc, char **argv)
+{
+    size_t records = argc > 1 ? size_t(std::strtoull(argv[1], nullptr, 10)) : 200000;
+    std::string json = make_document(records);
+
+    auto on_parse_error = [](const stc::json::parse_error&) { std::abort(); };
+    auto on_consume_error = [](const stc::doc_error&) { std::abort(); };
+
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::printf("document: %zu records, %zu bytes, %u hardware threads\n", records, json.size(), threads);
+
+    double serial_time = bench::measure("serial", json.size(), [&]
+    {
+        auto result = stc::json::from_json<std::vector<record>>(json, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    double parallel_time = bench::measure("parallel", json.size(), [&]
+    {
+        auto result = stc::json::from_json_parallel<std::vector<record>>(json, threads, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    bench::measure("parallel, 4 threads", json.size(), [&]
+    {
+        auto result = stc::json::from_json_parallel<std::vector<record>>(json, 4, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    std::printf("speedup: %.2fx\n", serial_time / parallel_time);
+}
@@ -0,0 +1,70 @@
+#include <any>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+#include <structurator/json_parser.hpp>
+#include <structurator/any_consumer.hpp>
+#include <structurator/object_mapper.hpp>
+
+#include "bench_utilities.hpp"
+
+/// Compares reading records with a large payload into std::any with skipping the payload via
+/// class_flag::ignore_unknown_keys, which lets the parser scan over it without tokenizing.
+
+struct full_record
+{
+    int id;
+    std::any payload;
+    stc_declare_class(full_record, id, payload);
+};
+
+struct id_record
+{
+    int id;
+    stc_declare_class_with(id_record, stc::class_flag::ignore_unknown_keys, id);
+};
+
+/// Document in which nearly all bytes belong to values of keys that are not needed.
+static std::string make_document(size_t records)
+{
+    std::string json = "[";
+    for(size_t i = 0; i < records; ++i)
+    {
+        json += i == 0 ? "\n" : ",\n";
+        json += "  { \"id\": " + std::to_string(i) + ", \"payload\": { \"text\": \"record \\\"" + std::to_string(i) + "\\\" [raw]\", \"values\": [";
+        for(size_t v = 0; v < 16; ++v)
+            json += (v == 0 ? "" : ", ") + std::to_string(v * 31 + i);
+
+        json += "], \"nested\": { \"a\": [ { \"b\": null }, { \"c\": true } ], \"d\": \"" + std::string(48, 'x') + "\" } } }";
+    }
+
+    return json + "\n]\n";
+}
+
+int main(int argc, char **argv)
+{
+    size_t records = argc > 1 ? size_t(std::strtoull(argv[1], nullptr, 10)) : 20000;
+    std::string json = make_document(records);
+
+    auto on_parse_error = [](const stc::json::parse_error&) { std::abort(); };
+    auto on_consume_error = [](const stc::doc_error&) { std::abort(); };
+
+    std::printf("document: %zu records, %zu bytes\n", records, json.size());
+
+    double full_time = bench::measure("payload into std::any", json.size(), [&]
+    {
+        auto result = stc::json::from_json<std::vector<full_record>>(json, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    double skip_time = bench::measure("payload skipped", json.size(), [&]
+    {
+        auto result = stc::json::from_json<std::vector<id_record>>(json, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    std::printf("speedup: %.2fx\n", full_time / skip_time);
+}
@@ -0,0 +1,86 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+
+#include <structurator/json_parser.hpp>
+#include <structurator/soa_vector.hpp>
+#include <structurator/object_mapper.hpp>
+
+#include "bench_utilities.hpp"
+
+/// Compares reading an array of flat records into std::vector<T> and into soa_vector<T>, and then summing a single
+/// member over all rows.
+
+struct trade
+{
+    std::int64_t id = 0;
+    std::string symbol;
+    std::string venue;
+    double price = 0.0;
+    double quantity = 0.0;
+    std::int64_t timestamp = 0;
+    stc_declare_class(trade, id, symbol, venue, price, quantity, timestamp);
+};
+
+static std::string make_document(size_t trades)
+{
+    std::string json = "[";
+    for(size_t i = 0; i < trades; ++i)
+    {
+        json += i == 0 ? "\n" : ",\n";
+        json += "{\"id\":" + std::to_string(i) + ",\"symbol\":\"SYM" + std::to_string(i % 500) + "\",\"venue\":\"XNAS\",\"price\":";
+        json += std::to_string(100 + (i % 1000) * 0.01) + ",\"quantity\":" + std::to_string(i % 300) + ",\"timestamp\":" + std::to_string(1700000000000 + i) + "}";
+    }
+
+    return json + "\n]\n";
+}
+
+int main(int argc, char **argv)
+{
+    size_t trades = argc > 1 ? size_t(std::strtoull(argv[1], nullptr, 10)) : 1000000;
+    std::string json = make_document(trades);
+
+    auto on_parse_error = [](const stc::json::parse_error&) { std::abort(); };
+    auto on_consume_error = [](const stc::doc_error&) { std::abort(); };
+
+    std::printf("document: %zu trades, %zu bytes\n", trades, json.size());
+
+    std::vector<trade> rows;
+    bench::measure("std::vector<T>", json.size(), [&]
+    {
+        rows = *stc::json::from_json<std::vector<trade>>(json, on_parse_error, on_consume_error);
+    });
+
+    stc::soa_vector<trade> columns;
+    bench::measure("soa_vector<T>", json.size(), [&]
+    {
+        columns = *stc::json::from_json<stc::soa_vector<trade>>(json, on_parse_error, on_consume_error);
+    });
+
+    double row_sum = 0.0;
+    double row_time = bench::measure("sum of prices, rows", trades * sizeof(double), [&]
+    {
+        row_sum = 0.0;
+        for(const trade &t : rows)
+            row_sum += t.price;
+
+        bench::keep(row_sum);
+    }, 50);
+
+    double column_sum = 0.0;
+    double column_time = bench::measure("sum of prices, column", trades * sizeof(double), [&]
+    {
+        column_sum = 0.0;
+        for(double price : columns.column(&trade::price))
+            column_sum += price;
+
+        bench::keep(column_sum);
+    }, 50);
+
+    if(row_sum != column_sum)
+        std::abort();
+
+    std::printf("speedup of scanning a column: %.2fx\n", row_time / column_time);
+}
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include <new>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+#include <structurator/arena.hpp>
+#include <structurator/json_parser.hpp>
+#include <structurator/owned_string.hpp>
+#include <structurator/object_mapper.hpp>
+#include <structurator/interned_string.hpp>
+
+#include "bench_utilities.hpp"
+
+/// Compares reading string-heavy records into std::string members, which copy every string, with std::string_view
+/// members referencing the document and an arena, with owned_string members adopting unescaped strings and with
+/// interned_string members for the strings which repeat. Also counts the allocations for records with short escaped
+/// strings, which ref_string stores inline after unescaping them.
+
+static size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    allocations++;
+    if(void *ptr = std::malloc(size != 0 ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+struct copied_request
+{
+    std::string host;
+    std::string path;
+    std::string agent;
+    stc_declare_class(copied_request, host, path, agent);
+};
+
+struct viewed_request
+{
+    std::string_view host;
+    std::string_view path;
+    std::string_view agent;
+    stc_declare_class(viewed_request, host, path, agent);
+};
+
+struct owned_request
+{
+    stc::owned_string host;
+    stc::owned_string path;
+    stc::owned_string agent;
+    stc_declare_class(owned_request, host, path, agent);
+};
+
+struct interned_request
+{
+    stc::interned_string host;
+    std::string path;
+    stc::interned_string agent;
+    stc_declare_class(interned_request, host, path, agent);
+};
+
+struct measurement
+{
+    std::string sensor;
+    std::string unit;
+    std::string note;
+    stc_declare_class(measurement, sensor, unit, note);
+};
+
+/// Document with long strings, of which the paths contain escaped slashes like many producers write them.
+static std::string make_document(size_t requests)
+{
+    std::string json = "[";
+    for(size_t i = 0; i < requests; ++i)
+    {
+        json += i == 0 ? "\n" : ",\n";
+        json += "  { \"host\": \"backend-" + std::to_string(i % 50) + ".eu-central.example.com\", ";
+        json += "\"path\": \"\\/api\\/v2\\/customers\\/" + std::to_string(i) + "\\/orders?page=" + std::to_string(i % 9) + "\", ";
+        json += "\"agent\": \"Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/" + std::to_string(100 + i % 30) + ".0\" }";
+    }
+
+    return json + "\n]\n";
+}
+
+/// Document with short strings that all contain escape sequences, but fit into std::string's own buffer.
+static std::string make_short_document(size_t measurements)
+{
+    std::string json = "[";
+    for(size_t i = 0; i < measurements; ++i)
+    {
+        json += i == 0 ? "\n" : ",\n";
+        json += "  { \"sensor\": \"caf\\u00e9-" + std::to_string(i % 1000) + "\", \"unit\": \"m\\/s\", \"note\": \"\\\"ok\\\"\" }";
+    }
+
+    return json + "\n]\n";
+}
+
+int main(int argc, char **argv)
+{
+    size_t requests = argc > 1 ? size_t(std::strtoull(argv[1], nullptr, 10)) : 100000;
+    std::string json = make_document(requests);
+
+    auto on_parse_error = [](const stc::json::parse_error&) { std::abort(); };
+    auto on_consume_error = [](const stc::doc_error&) { std::abort(); };
+
+    std::printf("document: %zu requests, %zu bytes\n", requests, json.size());
+
+    double copied_time = bench::measure("std::string members", json.size(), [&]
+    {
+        auto result = stc::json::from_json<std::vector<copied_request>>(json, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    double owned_time = bench::measure("owned_string members", json.size(), [&]
+    {
+        auto result = stc::json::from_json<std::vector<owned_request>>(json, on_parse_error, on_consume_error);
+        bench::keep(result);
+    });
+
+    stc::arena strings;
+    double viewed_time = bench::measure("std::string_view members", json.size(), [&]
+    {
+        strings.reset();
+        stc::doc_context context{ on_consume_error, true };
+        stc::json::input_options options;
+        options.strings = &strings;
+
+        auto result = stc::json::from_json_with_context<std::vector<viewed_request>>(json, on_parse_error, context, options);
+        bench::keep(result);
+    });
+
+    stc::string_pool pool;
+    double interned_time = bench::measure("interned_string members", json.size(), [&]
+    {
+        stc::doc_context context{ on_consume_error, false, &pool };
+        auto result = stc::json::from_json_with_context<std::vector<interned_request>>(json, on_parse_error, context);
+        bench::keep(result);
+    });
+
+    std::printf("speedup of owned_string: %.2fx, of std::string_view: %.2fx, of interning: %.2fx (%zu distinct strings)\n",
+        copied_time / owned_time, copied_time / viewed_time, copied_time / interned_time, pool.size());
+
+    std::string short_json = make_short_document(requests);
+    std::printf("document: %zu measurements with short escaped strings, %zu bytes\n", requests, short_json.size());
+
+    size_t runs = 0;
+    size_t before = allocations;
+    bench::measure("short escaped std::string", short_json.size(), [&]
+    {
+        auto result = stc::json::from_json<std::vector<measurement>>(short_json, on_parse_error, on_consume_error);
+        bench::keep(result);
+        runs++;
+    });
+
+    std::printf("allocations per document: %zu\n", (allocations - before) / runs);
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+///
+/// \file
+/// \brief Minimal timing helpers shared by the benchmarks. Build in release mode for meaningful numbers.
+///
+
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+#include <algorithm>
+#include <string_view>
+
+namespace bench
+{
+
+/// Prevents the compiler from discarding a computed value.
+template<class T>
+void keep(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static const void *volatile sink;
+    sink = &value;
+#endif
+}
+
+/// Runs \p fn repeatedly and prints the throughput of the fastest run, which processed \p bytes each time.
+/// Returns the duration of the fastest run in seconds.
+template<class Fn>
+double measure(std::string_view name, size_t bytes, Fn &&fn, int runs = 10)
+{
+    using clock = std::chrono::steady_clock;
+
+    double best = 1e300;
+    for(int i = 0; i < runs; ++i)
+    {
+        auto begin = clock::now();
+        fn();
+        std::chrono::duration<double> elapsed = clock::now() - begin;
+        best = std::min(best, elapsed.count());
+    }
+
+    std::printf("%-32.*s %9.3f ms %9.1f MB/s\n", int(name.size()), name.data(), best * 1e3, bytes / best / 1e6);
+    return best;
+}
+
+}
\ No newline at end of file
@@ -17,7 +17,8 @@ namespace stc
 {
 
 /// Defines consume() for reading std::any from documents.
-inline std::any consume(type_wrap<std::any>, doc_input::token_kind first, doc_input &input, const doc_context &context)
+template<class Input>
+std::any consume(type_wrap<std::any>, doc_input::token_kind first, Input &input, const doc_context &context)
 {
     using tok = doc_input::token_kind;
     switch(first)
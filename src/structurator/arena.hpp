@@ -0,0 +1,170 @@
+#pragma once
+
+///
+/// \file
+/// \brief Defines a bump allocator for memory which lives as long as a single document is read.
+///
+
+#include <new>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+namespace stc
+{
+
+/// Hands out memory by advancing a pointer within large blocks. Single allocations are never freed, instead
+/// reset() makes all memory available again without freeing any block. Reading many documents with the same
+/// arena therefore stops allocating once its blocks suffice for the largest document.
+/// Objects may be constructed within the arena as well, see create(). reset() takes O(1) only when none of them
+/// needs a destructor; otherwise it runs the destructors of these objects in reverse order. Not thread-safe.
+class arena
+{
+public:
+    static constexpr size_t max_block_size = 1024 * 1024; ///< Blocks grow up to this size, unless larger allocations require more.
+
+    explicit arena(size_t first_block_size = 4096) : first_block_size(std::max(first_block_size, size_t(64))) {}
+
+    arena(const arena&) = delete;
+    arena &operator=(const arena&) = delete;
+
+    ~arena()
+    {
+        destroy_objects();
+    }
+
+    /// Returns memory for \p size bytes aligned to \p alignment, which must be a power of two not larger than
+    /// alignof(std::max_align_t). The memory stays valid until reset() is called or the arena is destroyed.
+    void *allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        size_t offset = (block_used + alignment - 1) & ~(alignment - 1);
+        if(blocks.empty() || offset + size > blocks[current].size)
+        {
+            next_block(size);
+            offset = 0;
+        }
+
+        block_used = offset + size;
+        total_used += size;
+        return blocks[current].data.get() + offset;
+    }
+
+    /// Returns memory for \p size characters.
+    char *allocate_chars(size_t size)
+    {
+        return static_cast<char*>(allocate(size, 1));
+    }
+
+    /// Constructs an object within the arena, which lives until reset() is called or the arena is destroyed. Its
+    /// destructor is called then, unless it is trivially destructible, so graphs of trivially destructible objects are
+    /// released without visiting them.
+    template<class T, class... Args>
+    T *create(Args&&... args)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported.");
+
+        void *memory = allocate(sizeof(T), alignof(T));
+        if constexpr(std::is_trivially_destructible_v<T>)
+        {
+            return new(memory) T(std::forward<Args>(args)...);
+        }
+        else
+        {
+            destructors.reserve(destructors.size() + 1); //the object must not be left without destructor
+            T *object = new(memory) T(std::forward<Args>(args)...);
+            destroy_on_reset(object, 1);
+            return object;
+        }
+    }
+
+    /// Makes reset() call the destructors of \p count objects at \p objects, which were constructed within memory of
+    /// the arena by the caller. Does nothing for trivially destructible types. If this throws, the objects were not
+    /// registered.
+    template<class T>
+    void destroy_on_reset(T *objects, size_t count)
+    {
+        if constexpr(!std::is_trivially_destructible_v<T>)
+        {
+            if(count != 0)
+                destructors.push_back(destructor{ objects, count, [](void *ptr, size_t n) { std::destroy_n(static_cast<T*>(ptr), n); } });
+        }
+    }
+
+    /// Makes all memory available again, invalidating everything allocated before. Keeps all blocks for reuse.
+    /// Destroys the objects constructed by create() and registered by destroy_on_reset() in reverse order.
+    void reset()
+    {
+        destroy_objects();
+        current = 0;
+        block_used = 0;
+        total_used = 0;
+    }
+
+    /// Number of bytes allocated since construction or the last reset().
+    size_t used() const
+    {
+        return total_used;
+    }
+
+    /// Number of bytes within all blocks.
+    size_t capacity() const
+    {
+        size_t sum = 0;
+        for(const block &b : blocks)
+            sum += b.size;
+
+        return sum;
+    }
+
+private:
+    struct block
+    {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    struct destructor
+    {
+        void *objects;
+        size_t count;
+        void (*destroy)(void *objects, size_t count);
+    };
+
+    size_t first_block_size;
+    std::vector<block> blocks;
+    size_t current = 0; ///< Index of the block allocations are taken from.
+    size_t block_used = 0; ///< Number of bytes used within the current block.
+    size_t total_used = 0;
+    std::vector<destructor> destructors; ///< Objects which are not trivially destructible, in order of construction.
+
+    void destroy_objects()
+    {
+        while(!destructors.empty())
+        {
+            destructor last = destructors.back();
+            destructors.pop_back();
+            last.destroy(last.objects, last.count);
+        }
+    }
+
+    /// Moves on to the next block which can hold \p min_size bytes, reusing blocks kept by reset() or adding a new one.
+    void next_block(size_t min_size)
+    {
+        block_used = 0;
+        for(current = blocks.empty() ? 0 : current + 1; current < blocks.size(); ++current)
+        {
+            if(blocks[current].size >= min_size)
+                return;
+        }
+
+        size_t size = blocks.empty() ? first_block_size : std::min(blocks.back().size * 2, max_block_size);
+        size = std::max(size, min_size);
+        blocks.push_back(block{ std::unique_ptr<char[]>(new char[size]), size });
+        current = blocks.size() - 1;
+    }
+};
+
+}
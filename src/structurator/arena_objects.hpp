@@ -0,0 +1,235 @@
+#pragma once
+
+///
+/// \file
+/// \brief Defines arena_ptr, arena_vector and arena_string, which place the objects of a document in an arena.
+///
+/// Trees of std::unique_ptr and std::vector consist of many small heap allocations, which are as expensive to free.
+/// Values of these types are instead allocated from doc_context::objects. They are plain handles which do not own
+/// anything, so an object graph consisting of them and other trivially destructible members is freed all at once
+/// by arena::reset() without visiting it. Objects which are not trivially destructible are destroyed by the arena.
+///
+
+#include <new>
+#include <memory>
+#include <cassert>
+#include <cstring>
+#include <cstddef>
+#include <optional>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+
+#include "arena.hpp"
+#include "doc_consumer.hpp"
+
+namespace stc
+{
+
+/// Pointer to an object which is owned by an arena. Copies point to the same object.
+/// Like std::unique_ptr, it converts to pointers to base classes, so polymorphic alternatives of member_alts can be
+/// read as arena_ptr<Derived> into an arena_ptr<Base> member.
+template<class T>
+class arena_ptr
+{
+public:
+    arena_ptr() = default;
+    arena_ptr(std::nullptr_t) {}
+
+    explicit arena_ptr(T *object) : object(object) {}
+
+    template<class U, class = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    arena_ptr(const arena_ptr<U> &rhs) : object(rhs.get()) {}
+
+    T *get() const
+    {
+        return object;
+    }
+
+    T &operator*() const
+    {
+        return *object;
+    }
+
+    T *operator->() const
+    {
+        return object;
+    }
+
+    explicit operator bool() const
+    {
+        return object != nullptr;
+    }
+
+private:
+    T *object = nullptr;
+};
+
+/// Constructs an object within \p storage, see arena::create().
+template<class T, class... Args>
+arena_ptr<T> make_arena_ptr(arena &storage, Args&&... args)
+{
+    return arena_ptr<T>(storage.create<T>(std::forward<Args>(args)...));
+}
+
+
+/// Array of a fixed number of objects owned by an arena. Copies refer to the same elements.
+template<class T>
+class arena_vector
+{
+public:
+    arena_vector() = default;
+    arena_vector(T *elements, size_t count) : elements(elements), count(count) {}
+
+    T *data() const { return elements; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    T *begin() const { return elements; }
+    T *end() const { return elements + count; }
+
+    T &operator[](size_t index) const
+    {
+        assert(index < count);
+        return elements[index];
+    }
+
+private:
+    T *elements = nullptr;
+    size_t count = 0;
+};
+
+
+/// Read-only string whose characters are owned by an arena.
+class arena_string
+{
+public:
+    arena_string() = default;
+    arena_string(const char *chars, size_t length) : chars(chars), length(length) {}
+
+    /// Copies the given string into \p storage.
+    arena_string(std::string_view source, arena &storage) : chars(storage.allocate_chars(source.size())), length(source.size())
+    {
+        std::memcpy(const_cast<char*>(chars), source.data(), source.size());
+    }
+
+    const char *data() const { return chars; }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+
+    bool operator==(const arena_string &rhs) const
+    {
+        return std::string_view(*this) == std::string_view(rhs);
+    }
+
+    bool operator!=(const arena_string &rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    bool operator<(const arena_string &rhs) const
+    {
+        return std::string_view(*this) < std::string_view(rhs);
+    }
+
+    operator std::string_view() const
+    {
+        return std::string_view(chars, length);
+    }
+
+private:
+    const char *chars = nullptr;
+    size_t length = 0;
+};
+
+
+namespace detail
+{
+
+/// Returns doc_context::objects or reports storage_missing if it is not set.
+template<class Input>
+arena &context_arena(Input &input, const doc_context &context)
+{
+    if(context.objects == nullptr)
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::storage_missing });
+        throw doc_consume_exception();
+    }
+
+    return *context.objects;
+}
+
+} //end of detail
+
+
+/// Reads an object into doc_context::objects. Reports storage_missing if it is not set.
+template<class T, class Input>
+arena_ptr<T> consume(type_wrap<arena_ptr<T>>, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    arena &storage = detail::context_arena(input, context);
+    return arena_ptr<T>(storage.create<T>(consume(type_wrap<T>(), first, input, context)));
+}
+
+/// Reads an array into doc_context::objects, reporting storage_missing if it is not set. Elements are constructed in place. When the input
+/// gives no element_count_hint(), the capacity doubles, leaving the elements moved out of within the arena.
+template<class T, class Input>
+arena_vector<T> consume(type_wrap<arena_vector<T>>, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported.");
+
+    if(first != doc_input::token_kind::begin_array && !input.hint(doc_input::token_kind::begin_array))
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::type_mismatch });
+        throw doc_consume_exception();
+    }
+
+    arena &storage = detail::context_arena(input, context);
+    auto allocate = [&](size_t n) { return static_cast<T*>(storage.allocate(n * sizeof(T), alignof(T))); };
+
+    size_t capacity = input.element_count_hint().value_or(0);
+    T *elements = capacity != 0 ? allocate(capacity) : nullptr;
+    size_t count = 0;
+
+    try
+    {
+        doc_input::token_kind token;
+        while((token = input.next_token()) != doc_input::token_kind::end_array)
+        {
+            if(count == capacity)
+            {
+                capacity = std::max(capacity * 2, size_t(8));
+                T *grown = allocate(capacity);
+                std::uninitialized_move_n(elements, count, grown);
+                std::destroy_n(elements, count);
+                elements = grown;
+            }
+
+            new(elements + count) T(consume(type_wrap<T>(), token, input, context));
+            count++;
+        }
+
+        storage.destroy_on_reset(elements, count);
+    }
+    catch(...)
+    {
+        std::destroy_n(elements, count);
+        throw;
+    }
+
+    return arena_vector<T>(elements, count);
+}
+
+/// Copies a string into doc_context::objects. Reports storage_missing if it is not set.
+template<class Input>
+arena_string consume(type_wrap<arena_string>, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    if(first != doc_input::token_kind::string && !input.hint(doc_input::token_kind::string))
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::type_mismatch });
+        throw doc_consume_exception();
+    }
+
+    return arena_string(input.string(), detail::context_arena(input, context));
+}
+
+}
\ No newline at end of file
@@ -5,6 +5,10 @@
 /// \brief Defines some overflow-safe function for performing arithmetic.
 /// 
 
+#include <limits>
+#include <climits>
+#include <type_traits>
+
 #ifndef __has_builtin
     #define __has_builtin(x) 0
 #endif
@@ -28,6 +28,18 @@ enum class member_flag
     multiple = 16 ///<Collect all occurences in a sequence container.
 };
 
+/// Flags that modify the processing of a whole class, see stc_declare_class_with().
+enum class class_flag
+{
+    none = 0,
+    ignore_unknown_keys = 1, ///<Skip unknown keys and their values instead of reporting them. A member with member_flag::additional_keys takes precedence.
+};
+
+inline constexpr class_flag operator|(class_flag lhs, class_flag rhs)
+{
+    return class_flag(unsigned(lhs) | unsigned(rhs));
+}
+
 
 /// Contains flags and attributes.
 template<class... AttribT>
@@ -197,6 +209,7 @@ struct class_info
 {
     static constexpr size_t members_count = sizeof...(MembersInfo);
     std::tuple<MembersInfo...> members;
+    unsigned flags = 0; ///<Combination of class_flag values.
 };
 
 
@@ -229,6 +242,12 @@ static constexpr auto make_class_info(MembersInfo ...members_info)
     return class_info<Type, MembersInfo...>{ std::tuple(members_info...) };
 }
 
+template<class Type, class... MembersInfo>
+static constexpr auto make_class_info(class_flag flags, MembersInfo ...members_info)
+{
+    return class_info<Type, MembersInfo...>{ std::tuple(members_info...), unsigned(flags) };
+}
+
 
 template<class T>
 static constexpr decltype(T::stc_class_info(type_wrap<T>()), true) has_class_info_method(type_wrap<T>)
@@ -314,9 +333,58 @@ static constexpr auto get_class_info()
 #define STC_C13(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C12(type, __VA_ARGS__))
 #define STC_C14(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C13(type, __VA_ARGS__))
 #define STC_C15(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C14(type, __VA_ARGS__))
-
-#define STC_CLASS_MEMBERS_SELECT(_0,_1,_2,_3,_4,_5,_6,_7,_8,_9,_10,_11,_12,_13,_14,_15, macro, ...) macro 
-#define STC_CLASS_MEMBERS(type, ...) STC_EXPAND(STC_CLASS_MEMBERS_SELECT(_0,__VA_ARGS__,STC_C15,STC_C14,STC_C13,STC_C12,STC_C11,STC_C10,STC_C9,STC_C8,STC_C7,STC_C6,STC_C5,STC_C4,STC_C3,STC_C2,STC_C1,STC_C0)(type,__VA_ARGS__))
+#define STC_C16(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C15(type, __VA_ARGS__))
+#define STC_C17(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C16(type, __VA_ARGS__))
+#define STC_C18(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C17(type, __VA_ARGS__))
+#define STC_C19(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C18(type, __VA_ARGS__))
+#define STC_C20(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C19(type, __VA_ARGS__))
+#define STC_C21(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C20(type, __VA_ARGS__))
+#define STC_C22(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C21(type, __VA_ARGS__))
+#define STC_C23(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C22(type, __VA_ARGS__))
+#define STC_C24(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C23(type, __VA_ARGS__))
+#define STC_C25(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C24(type, __VA_ARGS__))
+#define STC_C26(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C25(type, __VA_ARGS__))
+#define STC_C27(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C26(type, __VA_ARGS__))
+#define STC_C28(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C27(type, __VA_ARGS__))
+#define STC_C29(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C28(type, __VA_ARGS__))
+#define STC_C30(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C29(type, __VA_ARGS__))
+#define STC_C31(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C30(type, __VA_ARGS__))
+#define STC_C32(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C31(type, __VA_ARGS__))
+#define STC_C33(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C32(type, __VA_ARGS__))
+#define STC_C34(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C33(type, __VA_ARGS__))
+#define STC_C35(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C34(type, __VA_ARGS__))
+#define STC_C36(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C35(type, __VA_ARGS__))
+#define STC_C37(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C36(type, __VA_ARGS__))
+#define STC_C38(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C37(type, __VA_ARGS__))
+#define STC_C39(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C38(type, __VA_ARGS__))
+#define STC_C40(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C39(type, __VA_ARGS__))
+#define STC_C41(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C40(type, __VA_ARGS__))
+#define STC_C42(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C41(type, __VA_ARGS__))
+#define STC_C43(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C42(type, __VA_ARGS__))
+#define STC_C44(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C43(type, __VA_ARGS__))
+#define STC_C45(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C44(type, __VA_ARGS__))
+#define STC_C46(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C45(type, __VA_ARGS__))
+#define STC_C47(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C46(type, __VA_ARGS__))
+#define STC_C48(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C47(type, __VA_ARGS__))
+#define STC_C49(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C48(type, __VA_ARGS__))
+#define STC_C50(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C49(type, __VA_ARGS__))
+#define STC_C51(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C50(type, __VA_ARGS__))
+#define STC_C52(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C51(type, __VA_ARGS__))
+#define STC_C53(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C52(type, __VA_ARGS__))
+#define STC_C54(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C53(type, __VA_ARGS__))
+#define STC_C55(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C54(type, __VA_ARGS__))
+#define STC_C56(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C55(type, __VA_ARGS__))
+#define STC_C57(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C56(type, __VA_ARGS__))
+#define STC_C58(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C57(type, __VA_ARGS__))
+#define STC_C59(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C58(type, __VA_ARGS__))
+#define STC_C60(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C59(type, __VA_ARGS__))
+#define STC_C61(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C60(type, __VA_ARGS__))
+#define STC_C62(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C61(type, __VA_ARGS__))
+#define STC_C63(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C62(type, __VA_ARGS__))
+#define STC_C64(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_EXPAND(STC_C63(type, __VA_ARGS__))
+
+#define STC_CLASS_MEMBERS_SELECT(_0,_1,_2,_3,_4,_5,_6,_7,_8,_9,_10,_11,_12,_13,_14,_15,_16,_17,_18,_19,_20,_21,_22,_23,_24,_25,_26,_27,_28,_29,_30,_31,_32,_33,_34,_35,_36,_37,_38,_39,_40,_41,_42,_43,_44,_45,_46,_47,_48,_49,_50,_51,_52,_53,_54,_55,_56,_57,_58,_59,_60,_61,_62,_63,_64, macro, ...) macro 
+#define STC_CLASS_MEMBERS(type, ...) STC_EXPAND(STC_CLASS_MEMBERS_SELECT(_0,__VA_ARGS__,STC_C64,STC_C63,STC_C62,STC_C61,STC_C60,STC_C59,STC_C58,STC_C57,STC_C56,STC_C55,STC_C54,STC_C53,STC_C52,STC_C51,STC_C50,STC_C49,STC_C48,STC_C47,STC_C46,STC_C45,STC_C44,STC_C43,STC_C42,STC_C41,STC_C40,STC_C39,STC_C38,STC_C37,STC_C36,STC_C35,STC_C34,STC_C33,STC_C32,STC_C31,STC_C30,STC_C29,STC_C28,STC_C27,STC_C26,STC_C25,STC_C24,STC_C23,STC_C22,STC_C21,STC_C20,STC_C19,STC_C18,STC_C17,STC_C16,STC_C15,STC_C14,STC_C13,STC_C12,STC_C11,STC_C10,STC_C9,STC_C8,STC_C7,STC_C6,STC_C5,STC_C4,STC_C3,STC_C2,STC_C1,STC_C0)(type,__VA_ARGS__))
 
 
 #else //now the same without STC_EXPAND
@@ -342,9 +410,58 @@ static constexpr auto get_class_info()
 #define STC_C13(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C12(type, __VA_ARGS__)
 #define STC_C14(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C13(type, __VA_ARGS__)
 #define STC_C15(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C14(type, __VA_ARGS__)
-
-#define STC_CLASS_MEMBERS_SELECT(_0,_1,_2,_3,_4,_5,_6,_7,_8,_9,_10,_11,_12,_13,_14,_15, macro, ...) macro 
-#define STC_CLASS_MEMBERS(type, ...) STC_CLASS_MEMBERS_SELECT(_0,__VA_ARGS__,STC_C15,STC_C14,STC_C13,STC_C12,STC_C11,STC_C10,STC_C9,STC_C8,STC_C7,STC_C6,STC_C5,STC_C4,STC_C3,STC_C2,STC_C1,STC_C0)(type,__VA_ARGS__)
+#define STC_C16(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C15(type, __VA_ARGS__)
+#define STC_C17(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C16(type, __VA_ARGS__)
+#define STC_C18(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C17(type, __VA_ARGS__)
+#define STC_C19(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C18(type, __VA_ARGS__)
+#define STC_C20(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C19(type, __VA_ARGS__)
+#define STC_C21(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C20(type, __VA_ARGS__)
+#define STC_C22(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C21(type, __VA_ARGS__)
+#define STC_C23(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C22(type, __VA_ARGS__)
+#define STC_C24(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C23(type, __VA_ARGS__)
+#define STC_C25(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C24(type, __VA_ARGS__)
+#define STC_C26(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C25(type, __VA_ARGS__)
+#define STC_C27(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C26(type, __VA_ARGS__)
+#define STC_C28(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C27(type, __VA_ARGS__)
+#define STC_C29(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C28(type, __VA_ARGS__)
+#define STC_C30(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C29(type, __VA_ARGS__)
+#define STC_C31(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C30(type, __VA_ARGS__)
+#define STC_C32(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C31(type, __VA_ARGS__)
+#define STC_C33(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C32(type, __VA_ARGS__)
+#define STC_C34(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C33(type, __VA_ARGS__)
+#define STC_C35(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C34(type, __VA_ARGS__)
+#define STC_C36(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C35(type, __VA_ARGS__)
+#define STC_C37(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C36(type, __VA_ARGS__)
+#define STC_C38(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C37(type, __VA_ARGS__)
+#define STC_C39(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C38(type, __VA_ARGS__)
+#define STC_C40(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C39(type, __VA_ARGS__)
+#define STC_C41(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C40(type, __VA_ARGS__)
+#define STC_C42(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C41(type, __VA_ARGS__)
+#define STC_C43(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C42(type, __VA_ARGS__)
+#define STC_C44(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C43(type, __VA_ARGS__)
+#define STC_C45(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C44(type, __VA_ARGS__)
+#define STC_C46(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C45(type, __VA_ARGS__)
+#define STC_C47(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C46(type, __VA_ARGS__)
+#define STC_C48(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C47(type, __VA_ARGS__)
+#define STC_C49(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C48(type, __VA_ARGS__)
+#define STC_C50(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C49(type, __VA_ARGS__)
+#define STC_C51(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C50(type, __VA_ARGS__)
+#define STC_C52(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C51(type, __VA_ARGS__)
+#define STC_C53(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C52(type, __VA_ARGS__)
+#define STC_C54(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C53(type, __VA_ARGS__)
+#define STC_C55(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C54(type, __VA_ARGS__)
+#define STC_C56(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C55(type, __VA_ARGS__)
+#define STC_C57(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C56(type, __VA_ARGS__)
+#define STC_C58(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C57(type, __VA_ARGS__)
+#define STC_C59(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C58(type, __VA_ARGS__)
+#define STC_C60(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C59(type, __VA_ARGS__)
+#define STC_C61(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C60(type, __VA_ARGS__)
+#define STC_C62(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C61(type, __VA_ARGS__)
+#define STC_C63(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C62(type, __VA_ARGS__)
+#define STC_C64(type, member, ...) STC_MEMBER_INFO_WRAP(type, member),STC_C63(type, __VA_ARGS__)
+
+#define STC_CLASS_MEMBERS_SELECT(_0,_1,_2,_3,_4,_5,_6,_7,_8,_9,_10,_11,_12,_13,_14,_15,_16,_17,_18,_19,_20,_21,_22,_23,_24,_25,_26,_27,_28,_29,_30,_31,_32,_33,_34,_35,_36,_37,_38,_39,_40,_41,_42,_43,_44,_45,_46,_47,_48,_49,_50,_51,_52,_53,_54,_55,_56,_57,_58,_59,_60,_61,_62,_63,_64, macro, ...) macro 
+#define STC_CLASS_MEMBERS(type, ...) STC_CLASS_MEMBERS_SELECT(_0,__VA_ARGS__,STC_C64,STC_C63,STC_C62,STC_C61,STC_C60,STC_C59,STC_C58,STC_C57,STC_C56,STC_C55,STC_C54,STC_C53,STC_C52,STC_C51,STC_C50,STC_C49,STC_C48,STC_C47,STC_C46,STC_C45,STC_C44,STC_C43,STC_C42,STC_C41,STC_C40,STC_C39,STC_C38,STC_C37,STC_C36,STC_C35,STC_C34,STC_C33,STC_C32,STC_C31,STC_C30,STC_C29,STC_C28,STC_C27,STC_C26,STC_C25,STC_C24,STC_C23,STC_C22,STC_C21,STC_C20,STC_C19,STC_C18,STC_C17,STC_C16,STC_C15,STC_C14,STC_C13,STC_C12,STC_C11,STC_C10,STC_C9,STC_C8,STC_C7,STC_C6,STC_C5,STC_C4,STC_C3,STC_C2,STC_C1,STC_C0)(type,__VA_ARGS__)
 
 
 #endif
@@ -352,7 +469,11 @@ static constexpr auto get_class_info()
 /// \def stc_declare_class
 /// Declares class information for \p type by defining either a method or a free function.
 /// Variadic arguments may either be of form <member> or (<member>, <member options>).
-/// The former declares a member without any options.
+/// The former declares a member without any options. Up to 64 members can be declared.
 #define stc_declare_class(type, ...) static constexpr auto stc_class_info(::stc::type_wrap<type>){ return ::stc::detail::make_class_info<type>( STC_EXPAND(STC_CLASS_MEMBERS(type, __VA_ARGS__)) ); }
 
+/// \def stc_declare_class_with
+/// Like stc_declare_class(), but additionally applies class_flag values given by \p flags to the whole class.
+#define stc_declare_class_with(type, flags, ...) static constexpr auto stc_class_info(::stc::type_wrap<type>){ return ::stc::detail::make_class_info<type>( (flags), STC_EXPAND(STC_CLASS_MEMBERS(type, __VA_ARGS__)) ); }
+
 }
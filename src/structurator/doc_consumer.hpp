@@ -8,6 +8,8 @@
 /// Errors are handled by given it to an error handler and then raising a doc_consume_exception.
 ///
 
+#include <utility>
+#include <iterator>
 #include <exception>
 #include <functional>
 #include <type_traits>
@@ -40,6 +42,8 @@ struct doc_error
         key_duplicate,
         key_missing,
         index_out_of_bounds,
+        value_not_referenceable,
+        storage_missing, ///< The context lacks the pool or arena which the value has to be stored into.
     } what;
 };
 
@@ -62,8 +66,11 @@ inline std::string_view enum_string(doc_error::kind what)
         "Key is duplicated.",
         "Not all required keys are specified.",
         "Value is not a valid index.",
+        "String cannot be referenced without copying it.",
+        "No pool or arena to store this value was provided.",
     };
 
+    static_assert(std::size(msgs) == unsigned(doc_error::kind::storage_missing) + 1, "Message missing for doc_error::kind.");
     return msgs[unsigned(what)];
 }
 #endif
@@ -71,12 +78,25 @@ inline std::string_view enum_string(doc_error::kind what)
 
 using doc_error_handler = std::function<void(const doc_error&)>;
 
+class arena;
+class string_pool;
+
 
 /// Object which is passed to every consume()-function.
 /// This class may be inherited and equipped for custom consume() functions.
 struct doc_context
 {
     doc_error_handler error_handler;
+
+    /// Guarantees that the source document, and the arena which receives unescaped strings, outlive the values
+    /// read, so that std::string_view values may reference them instead of copying strings.
+    bool document_outlives_values = false;
+
+    /// Pool which interned_string values and keys are interned into, see interned_string.hpp. It must outlive them.
+    string_pool *strings = nullptr;
+
+    /// Arena which arena_ptr, arena_vector and arena_string values are allocated from, see arena_objects.hpp.
+    arena *objects = nullptr;
 };
 
 /// Raised by a consume() function when an error occurred.
@@ -88,8 +108,10 @@ struct doc_consume_exception : public std::exception
 
 
 /// Default consume() function for unknown types.
+/// Takes the input as const, so it is a worse match than any actual consume() function, whether it takes a
+/// specific input type or doc_input.
 template<class T>
-T consume(T, doc_input::token_kind, doc_input&, const doc_context&)
+T consume(T, doc_input::token_kind, const doc_input&, const doc_context&)
 {
     if constexpr(std::is_class_v<T>)
         static_assert(std::is_same_v<T, void>, "This type does not have an appropriate consume() function, maybe due to a missing stc_declare_class().");
@@ -98,4 +120,37 @@ T consume(T, doc_input::token_kind, doc_input&, const doc_context&)
 }
 
 
+/// Converts the key of a mapping entry into the key type of a map, which must be constructible from ref_string.
+/// Overloads for other key types are found by argument-dependent lookup like consume(), see interned_string.hpp.
+template<class K, class Input>
+K consume_key(type_wrap<K>, ref_string &&key, Input&, const doc_context&)
+{
+    static_assert(std::is_constructible_v<K, ref_string&&>, "Keys must be constructible from ref_string or have a consume_key() function.");
+    return K(std::move(key));
+}
+
+
+namespace detail
+{
+
+template<class T, class Input, class = void>
+struct has_consume_into : std::false_type {};
+
+template<class T, class Input>
+struct has_consume_into<T, Input, std::void_t<decltype(consume_into(std::declval<T&>(), doc_input::token_kind(), std::declval<Input&>(), std::declval<const doc_context&>()))>> : std::true_type {};
+
+} //end of detail
+
+/// Reads a value into an existing object, so it may keep memory it allocated before, like the capacity of strings and
+/// containers. Calls consume_into(T &target, first, input, context) when such a function exists for T, which is found
+/// by argument-dependent lookup like consume(), and otherwise assigns the result of consume().
+template<class T, class Input>
+void consume_existing(T &target, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    if constexpr(detail::has_consume_into<T, Input>::value)
+        consume_into(target, first, input, context);
+    else
+        target = consume(type_wrap<T>(), first, input, context);
+}
+
 }
\ No newline at end of file
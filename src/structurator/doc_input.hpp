@@ -64,6 +64,46 @@ struct doc_input
     /// Returns whether successful.
     virtual bool hint(token_kind) { return false; }
 
+    /// Returns the number of elements of the array or entries of the mapping of which the begin token was just
+    /// returned by next_token(), if the parser can tell cheaply, so consumers can reserve memory. Binary formats
+    /// usually store it, text parsers may count ahead. It is only a hint, which may be wrong for invalid documents.
+    virtual std::optional<size_t> element_count_hint() { return std::nullopt; }
+
+    /// Skips the value of which \p first was just returned by next_token(), so the next call to next_token()
+    /// returns the token after it. Nothing is skipped for scalars, containers are skipped up to and including their
+    /// end token. Parsers may override it to skip without tokenizing and do not have to validate the skipped input.
+    virtual void skip_value(token_kind first)
+    {
+        if(first != token_kind::begin_mapping && first != token_kind::begin_array)
+            return;
+
+        for(size_t depth = 1; depth > 0; )
+        {
+            token_kind token = next_token();
+            if(token == token_kind::begin_mapping || token == token_kind::begin_array)
+                depth++;
+            else if(token == token_kind::end_mapping || token == token_kind::end_array)
+                depth--;
+            else if(token == token_kind::eof)
+                return;
+        }
+    }
+
+    /// Reads the elements of the array of which the begin token was just returned by next_token() while they are
+    /// numbers, calling \p on_number() after each one became the current token. Returns the token which ended the
+    /// run: end_array, or the first element which is not a number, which is current then.
+    /// Templates cannot be virtual, so parsers provide a faster loop by hiding this one, which consumers only reach
+    /// when they know the parser's type, like with from_json().
+    template<class Fn>
+    token_kind read_number_array(Fn &&on_number)
+    {
+        token_kind token;
+        while((token = next_token()) == token_kind::number)
+            on_number();
+
+        return token;
+    }
+
     enum class relative_loc
     {
         value, ///< Location of the current token.
@@ -87,6 +127,22 @@ struct doc_input
     /// The integral part is always present, the other two parts may be missing.
     virtual ref_string &&raw_number() = 0;
 
+    /// The current number as integer, if the parser decoded it while reading and it fits without fraction and without
+    /// negative exponent. Returns nullopt otherwise, in which case raw_number() is still available.
+    /// The current token must be a number.
+    virtual std::optional<std::int64_t> int64_value() { return std::nullopt; }
+
+    /// Like int64_value() for non-negative integers.
+    virtual std::optional<std::uint64_t> uint64_value() { return std::nullopt; }
+
+    /// The current number as correctly rounded floating-point number, if the parser could decode it cheaply.
+    /// Returns nullopt otherwise, in which case raw_number() is still available.
+    /// The current token must be a number.
+    virtual std::optional<double> double_value() { return std::nullopt; }
+
+    /// Like double_value() for float, which is rounded from the number directly instead of from a double.
+    virtual std::optional<float> float_value() { return std::nullopt; }
+
     /// Current string literal.
     /// The current token must be a string.
     /// ref_string ensures that no unneccesary copies of the string are made when a simple view suffices.
@@ -1,6 +1,19 @@
+#include <cerrno>
+#include <cstdint>
 #include <climits>
+#include <utility>
 #include <fstream>
-#include <filesystem>
+#include <istream>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #include "input_utilities.hpp"
 
@@ -32,4 +45,147 @@ std::optional<std::string> read_file(const std::string &path)
 }
 
 
+#ifndef _WIN32
+/// Appends everything that can be read from the file descriptor. Returns false on error.
+static bool read_all(int fd, std::string &contents)
+{
+    static constexpr size_t chunk_size = 64 * 1024;
+
+    size_t size = contents.size();
+    while(true)
+    {
+        contents.resize(size + chunk_size);
+        auto count = ::read(fd, contents.data() + size, chunk_size);
+        if(count < 0 && errno == EINTR)
+            continue;
+
+        if(count <= 0)
+        {
+            contents.resize(size);
+            return count == 0;
+        }
+
+        size += size_t(count);
+    }
+}
+#endif
+
+std::optional<mapped_file> mapped_file::open(const std::string &path, map_options options)
+{
+    mapped_file file;
+
+#ifdef _WIN32
+    (void)options;
+    auto contents = read_file(path);
+    if(!contents)
+        return std::nullopt;
+
+    file.contents = std::move(*contents);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+        return std::nullopt;
+
+    //only regular files report their actual size, empty ones cannot be mapped
+    struct stat status;
+    if(::fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0 && std::uintmax_t(status.st_size) <= SIZE_MAX)
+    {
+        int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+        if(options.populate)
+            flags |= MAP_POPULATE;
+#endif
+
+        size_t size = size_t(status.st_size);
+        void *addr = ::mmap(nullptr, size, PROT_READ, flags, fd, 0);
+        if(addr != MAP_FAILED)
+        {
+            if(options.sequential)
+                ::madvise(addr, size, MADV_SEQUENTIAL);
+
+            ::close(fd);
+            file.ptr = static_cast<const char*>(addr);
+            file.length = size;
+            file.mapped = true;
+            return file;
+        }
+    }
+
+    bool success = read_all(fd, file.contents);
+    ::close(fd);
+    if(!success)
+        return std::nullopt;
+#endif
+
+    file.ptr = file.contents.data();
+    file.length = file.contents.size();
+    return file;
+}
+
+mapped_file::mapped_file(mapped_file &&rhs) noexcept
+{
+    *this = std::move(rhs);
+}
+
+mapped_file &mapped_file::operator=(mapped_file &&rhs) noexcept
+{
+    if(this == &rhs)
+        return *this;
+
+    unmap();
+
+    mapped = std::exchange(rhs.mapped, false);
+    length = std::exchange(rhs.length, 0);
+    contents = std::move(rhs.contents);
+    ptr = mapped ? std::exchange(rhs.ptr, "") : contents.data(); //moving the string may change its data
+    rhs.ptr = "";
+    return *this;
+}
+
+mapped_file::~mapped_file()
+{
+    unmap();
+}
+
+void mapped_file::unmap()
+{
+#ifndef _WIN32
+    if(mapped)
+        ::munmap(const_cast<char*>(ptr), length);
+#endif
+
+    mapped = false;
+}
+
+
+chunk_reader stream_reader(std::istream &stream)
+{
+    return [&stream](char *buffer, size_t size) -> size_t
+    {
+        stream.read(buffer, std::streamsize(size));
+        return size_t(stream.gcount());
+    };
+}
+
+chunk_reader fd_reader(int fd)
+{
+    return [fd](char *buffer, size_t size) -> size_t
+    {
+        while(true)
+        {
+#ifdef _WIN32
+            int count = _read(fd, buffer, unsigned(std::min(size, size_t(INT_MAX))));
+#else
+            auto count = ::read(fd, buffer, size);
+#endif
+            if(count >= 0)
+                return size_t(count);
+
+            if(errno != EINTR)
+                return 0;
+        }
+    };
+}
+
+
 }
\ No newline at end of file
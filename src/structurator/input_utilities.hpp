@@ -2,7 +2,10 @@
 
 #include <string>
 #include <iosfwd>
+#include <cstddef>
 #include <optional>
+#include <functional>
+#include <string_view>
 
 namespace stc
 {
@@ -11,4 +14,69 @@ namespace stc
 /// Returns nullopt on error.
 std::optional<std::string> read_file(const std::string &path);
 
+
+/// Options for mapping files into memory.
+struct map_options
+{
+    bool sequential = true; ///< Advises the system that the file is read sequentially (MADV_SEQUENTIAL), so pages are read ahead.
+    bool populate = false; ///< Reads the complete file when mapping it (MAP_POPULATE, Linux only), avoiding page faults later.
+};
+
+/// Read-only content of a file which is memory-mapped when possible, so it is not copied.
+/// Files which cannot be mapped, for instance pipes or files from procfs, are read into memory instead.
+class mapped_file
+{
+public:
+    /// Opens the file specified by its path. Returns nullopt on error.
+    static std::optional<mapped_file> open(const std::string &path, map_options options = {});
+
+    mapped_file(mapped_file &&rhs) noexcept;
+    mapped_file &operator=(mapped_file &&rhs) noexcept;
+    ~mapped_file();
+
+    /// Pointer to the first character of the content.
+    const char *data() const
+    {
+        return ptr;
+    }
+
+    /// Number of bytes of the content.
+    size_t size() const
+    {
+        return length;
+    }
+
+    operator std::string_view() const
+    {
+        return std::string_view(ptr, length);
+    }
+
+    /// Returns whether the content is memory-mapped rather than read into memory.
+    bool is_mapped() const
+    {
+        return mapped;
+    }
+
+private:
+    mapped_file() = default;
+    void unmap();
+
+    const char *ptr = "";
+    size_t length = 0;
+    bool mapped = false;
+    std::string contents; ///< Content of files which are not mapped.
+};
+
+
+/// Reads up to the given number of bytes into the buffer and returns the number of bytes read.
+/// Returns zero at the end of the input.
+using chunk_reader = std::function<size_t(char *buffer, size_t size)>;
+
+/// Returns a chunk_reader which reads from the given stream. The stream must outlive the reader.
+chunk_reader stream_reader(std::istream &stream);
+
+/// Returns a chunk_reader which reads from the given file descriptor, which is not closed by the reader.
+/// Read errors end the input.
+chunk_reader fd_reader(int fd);
+
 }
\ No newline at end of file
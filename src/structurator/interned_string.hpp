@@ -0,0 +1,164 @@
+#pragma once
+
+///
+/// \file
+/// \brief Defines interned_string for strings which repeat often within documents, like host names or map keys.
+///
+/// Equal strings read as interned_string share one immutable buffer of a string_pool, which is set as
+/// doc_context::strings. Reading a string that was interned before only looks it up and allocates nothing, and
+/// interned strings are compared by pointer.
+///
+
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <unordered_set>
+
+#include "arena.hpp"
+#include "doc_consumer.hpp"
+
+namespace stc
+{
+
+/// Reference to an immutable string within a string_pool. Copying it only copies a pointer.
+/// Strings of the same pool are equal if and only if they reference the same entry. Strings of different pools must
+/// not be compared for equality, and none of them may be used after their pool was destroyed.
+class interned_string
+{
+public:
+    /// Constructs an empty string, which equals the empty string of every pool.
+    interned_string() = default;
+
+    const char *data() const
+    {
+        return entry != nullptr ? entry->data() : nullptr;
+    }
+
+    size_t size() const
+    {
+        return entry != nullptr ? entry->size() : 0;
+    }
+
+    bool empty() const
+    {
+        return entry == nullptr;
+    }
+
+    bool operator==(const interned_string &rhs) const
+    {
+        return entry == rhs.entry;
+    }
+
+    bool operator!=(const interned_string &rhs) const
+    {
+        return entry != rhs.entry;
+    }
+
+    /// Orders by content, so maps of interned strings are sorted like maps of std::string.
+    bool operator<(const interned_string &rhs) const
+    {
+        return entry != rhs.entry && std::string_view(*this) < std::string_view(rhs);
+    }
+
+    operator std::string_view() const
+    {
+        return entry != nullptr ? *entry : std::string_view();
+    }
+
+private:
+    friend class string_pool;
+
+    explicit interned_string(const std::string_view *entry) : entry(entry) {}
+
+    const std::string_view *entry = nullptr; ///< Entry of the pool, or nullptr when empty.
+};
+
+
+/// Holds one copy of every distinct string interned into it, whose characters are placed in an arena.
+/// Not thread-safe, so a pool must not be shared by parsers running concurrently.
+class string_pool
+{
+public:
+    explicit string_pool(size_t first_block_size = 4096) : chars(first_block_size) {}
+
+    string_pool(const string_pool&) = delete;
+    string_pool &operator=(const string_pool&) = delete;
+
+    /// Returns the interned string equal to \p str, which is copied into the pool when it was not interned before.
+    interned_string intern(std::string_view str)
+    {
+        if(str.empty())
+            return interned_string();
+
+        auto found = entries.find(str);
+        if(found == entries.end())
+        {
+            char *ptr = chars.allocate_chars(str.size());
+            std::memcpy(ptr, str.data(), str.size());
+            found = entries.insert(std::string_view(ptr, str.size())).first;
+        }
+
+        return interned_string(&*found);
+    }
+
+    /// Number of distinct non-empty strings.
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+private:
+    arena chars;
+    std::unordered_set<std::string_view> entries; ///< Nodes are stable, so interned_string may point to them.
+};
+
+
+/// Reads a string and interns it into doc_context::strings. Reports storage_missing if it is not set.
+template<class Input>
+interned_string consume(type_wrap<interned_string>, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    if(first != doc_input::token_kind::string && !input.hint(doc_input::token_kind::string))
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::type_mismatch });
+        throw doc_consume_exception();
+    }
+
+    if(context.strings == nullptr)
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::storage_missing });
+        throw doc_consume_exception();
+    }
+
+    return context.strings->intern(input.string());
+}
+
+/// Interns keys of maps like std::map<interned_string, T> into doc_context::strings. Reports storage_missing if it
+/// is not set.
+template<class Input>
+interned_string consume_key(type_wrap<interned_string>, ref_string &&key, Input &input, const doc_context &context)
+{
+    if(context.strings == nullptr)
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::storage_missing });
+        throw doc_consume_exception();
+    }
+
+    return context.strings->intern(key);
+}
+
+}
+
+namespace std
+{
+
+/// Hashes the address of the characters, which is unique per interned string.
+template<>
+struct hash<stc::interned_string>
+{
+    size_t operator()(const stc::interned_string &str) const noexcept
+    {
+        return std::hash<const char*>()(str.data());
+    }
+};
+
+}
\ No newline at end of file
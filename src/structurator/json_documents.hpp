@@ -0,0 +1,156 @@
+#pragma once
+
+///
+/// \file
+/// \brief Defines document_stream for reading JSON values which follow each other without separators.
+///
+/// Producers often write root values back-to-back, like {...}{...}[...], optionally separated by whitespaces.
+/// A single parser reads all of them, so its buffers are only allocated once and locations refer to the whole source.
+///
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string_view>
+
+#include "json_parser.hpp"
+#include "object_mapper.hpp"
+
+namespace stc::json
+{
+
+/// Range over the root values of a source with several concatenated JSON documents, yielding a std::optional<T>
+/// per document which is empty when the document was erroneous. Errors are passed to the handlers with their
+/// location within the whole source. An erroneous document is skipped up to the end of its root value, so the
+/// following documents are still read. The range can only be iterated once and the source must outlive it.
+template<class T>
+class document_stream
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::optional<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::optional<T>*;
+        using reference = std::optional<T>&;
+
+        iterator() = default;
+
+        reference operator*() const
+        {
+            return stream->current;
+        }
+
+        pointer operator->() const
+        {
+            return &stream->current;
+        }
+
+        iterator &operator++()
+        {
+            if(!stream->read_next())
+                stream = nullptr;
+
+            return *this;
+        }
+
+        bool operator==(const iterator &rhs) const
+        {
+            return stream == rhs.stream;
+        }
+
+        bool operator!=(const iterator &rhs) const
+        {
+            return stream != rhs.stream;
+        }
+
+    private:
+        friend class document_stream;
+        explicit iterator(document_stream *stream) : stream(stream) {}
+
+        document_stream *stream = nullptr;
+    };
+
+    document_stream(std::string_view source, parse_error_handler parse_handler, doc_error_handler consume_handler, input_options options = {}) :
+        input(source, std::move(parse_handler), options), context{ std::move(consume_handler) }
+    {
+    }
+
+    document_stream(const document_stream&) = delete;
+    document_stream &operator=(const document_stream&) = delete;
+
+    /// Reads the first document.
+    iterator begin()
+    {
+        return iterator(read_next() ? this : nullptr);
+    }
+
+    iterator end()
+    {
+        return iterator();
+    }
+
+    /// Byte offset of the input which was not read yet, e.g. of an incomplete document at the end of a capture.
+    size_t offset() const
+    {
+        return input.source_offset + input.offset();
+    }
+
+private:
+    parser input;
+    doc_context context;
+    std::optional<T> current;
+
+    /// Reads the next document into current. Returns false at the end of the source.
+    bool read_next()
+    {
+        input.state = parser::parse_state::begin;
+        input.call_stack.clear();
+        input.error_count = 0;
+
+        input.skip_whitespaces();
+        if(input.source.empty())
+            return false;
+
+        const char *begin = input.source.data();
+        current = from_input_with_context<T>(input, context);
+        if(!current)
+            resynchronize(begin);
+
+        return true;
+    }
+
+    /// Moves behind the erroneous document which started at \p begin.
+    void resynchronize(const char *begin)
+    {
+        if(!input.call_stack.empty()) //skip the rest of the root container from its begin, the error may lie within a string
+        {
+            const parser::stack_entry &root = input.call_stack.front();
+            input.source = std::string_view(root.from, input.source.data() + input.source.size() - root.from);
+            input.line = root.line;
+
+            detail::raw_skip_state skip_state;
+            if(input.lazy_lines)
+            {
+                ignored_lines ignored;
+                detail::skip_raw_container(input.source, ignored, skip_state);
+            }
+            else
+            {
+                detail::skip_raw_container(input.source, input.line, skip_state);
+            }
+        }
+        else if(input.source.data() == begin) //invalid scalar, skip up to where another value may begin
+        {
+            while(!input.source.empty() && !is_whitespace(input.source.front()) &&
+                (input.source.data() == begin || (input.source.front() != '{' && input.source.front() != '[' && input.source.front() != '"')))
+            {
+                input.source.remove_prefix(1);
+            }
+        }
+    }
+};
+
+}
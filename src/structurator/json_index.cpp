@@ -0,0 +1,97 @@
+#include "json_index.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+
+#include "simd_utilities.hpp"
+
+
+namespace stc::json
+{
+
+structural_index::structural_index(std::string_view source) : source(source)
+{
+    structurals.reserve(window_blocks);
+    string_stops.reserve(window_blocks);
+}
+
+size_t structural_index::next_structural(size_t pos)
+{
+    return find(structurals, pos);
+}
+
+size_t structural_index::next_string_stop(size_t pos)
+{
+    return find(string_stops, pos);
+}
+
+void structural_index::index_next_window()
+{
+    window_begin = window_end;
+    window_end = std::min(source.size(), window_begin + window_blocks * simd_block::size);
+
+    size_t length = window_end - window_begin;
+    size_t blocks = (length + simd_block::size - 1) / simd_block::size;
+    structurals.resize(blocks);
+    string_stops.resize(blocks);
+
+    for(size_t i = 0; i < blocks; ++i)
+    {
+        const char *ptr = source.data() + window_begin + i * simd_block::size;
+
+        char padded[simd_block::size];
+        size_t remaining = length - i * simd_block::size;
+        if(remaining < simd_block::size) //pad last block with whitespace, which neither starts tokens nor stops strings
+        {
+            std::memset(padded, ' ', sizeof(padded));
+            std::memcpy(padded, ptr, remaining);
+            ptr = padded;
+        }
+
+        simd_block block(ptr);
+        std::uint64_t backslashes = block.equal('\\');
+        std::uint64_t quotes = block.equal('"');
+        std::uint64_t controls = block.less(32);
+        std::uint64_t whitespaces = block.equal(' ') | block.equal('\t') | block.equal('\n') | block.equal('\r') | block.equal('\f');
+        std::uint64_t operators = block.equal('{') | block.equal('}') | block.equal('[') | block.equal(']') | block.equal(':') | block.equal(',');
+
+        quotes &= ~find_escaped(backslashes, prev_escaped);
+
+        //bits from each opening quote up to but excluding the closing quote
+        std::uint64_t in_string = prefix_xor(quotes) ^ prev_in_string;
+        prev_in_string = std::uint64_t(0) - (in_string >> 63);
+
+        std::uint64_t scalars = ~(whitespaces | operators | quotes | in_string);
+        std::uint64_t scalar_starts = scalars & ~(scalars << 1 | prev_scalar);
+        prev_scalar = scalars >> 63;
+
+        structurals[i] = (operators & ~in_string) | (quotes & in_string) | scalar_starts;
+        string_stops[i] = (quotes & ~in_string) | ((backslashes | controls) & in_string);
+    }
+}
+
+size_t structural_index::find(const std::vector<std::uint64_t> &bitmap, size_t pos)
+{
+    assert(pos >= window_begin);
+    while(pos < source.size())
+    {
+        while(pos >= window_end)
+            index_next_window();
+
+        size_t relative = pos - window_begin;
+        size_t word = relative / simd_block::size;
+        std::uint64_t bits = bitmap[word] & (~std::uint64_t(0) << (relative % simd_block::size));
+        while(bits == 0 && ++word < bitmap.size())
+            bits = bitmap[word];
+
+        if(bits != 0)
+            return std::min(source.size(), window_begin + word * simd_block::size + trailing_zeros(bits));
+
+        pos = window_end;
+    }
+
+    return source.size();
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+///
+/// \file
+/// \brief Structural index which lets the JSON parser jump between tokens instead of scanning every byte.
+///
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace stc::json
+{
+
+/// Bitmaps of interesting positions within a JSON document, computed with SIMD in a pass ahead of the parser.
+/// A structural is a byte outside of string literals that begins a token: one of {}[]:, an opening quote
+/// or the first byte of any other literal. A string stop is a byte within a string literal at which a fast scan
+/// has to stop: the closing quote, a backslash or a control character.
+/// The document is indexed in windows of fixed size, so memory usage does not depend on the document's size.
+/// Lookups must be made at monotonically increasing positions. The index is only meaningful as long as the
+/// document is syntactically valid up to the position of the lookup.
+class structural_index
+{
+public:
+    explicit structural_index(std::string_view source);
+
+    /// Returns the position of the first structural at or after \p pos or the size of the document if there is none.
+    size_t next_structural(size_t pos);
+
+    /// Returns the position of the first string stop at or after \p pos or the size of the document if there is none.
+    size_t next_string_stop(size_t pos);
+
+private:
+    static constexpr size_t window_blocks = 1024; ///< Number of 64-byte blocks indexed at once.
+
+    std::string_view source;
+    size_t window_begin = 0; ///< Position of the first indexed byte.
+    size_t window_end = 0; ///< Position after the last indexed byte.
+    std::vector<std::uint64_t> structurals; ///< One bit per byte within the window.
+    std::vector<std::uint64_t> string_stops; ///< One bit per byte within the window.
+
+    //state carried from one block to the next
+    std::uint64_t prev_escaped = 0; ///< One when the first byte of the next block is escaped.
+    std::uint64_t prev_in_string = 0; ///< All ones when the last block ended within a string literal.
+    std::uint64_t prev_scalar = 0; ///< One when the last block ended within a literal other than a string.
+
+    void index_next_window();
+    size_t find(const std::vector<std::uint64_t> &bitmap, size_t pos);
+};
+
+}
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <string>
 #include <memory>
+#include <iterator>
 #include <functional>
 #include <string_view>
 
+#include "arena.hpp"
 #include "doc_input.hpp"
+#include "input_utilities.hpp"
 
 namespace stc::json
 {
@@ -21,6 +25,7 @@ struct parse_error
         string_invalid_newline,
         string_invalid_char,
         string_invalid_escape,
+        expected_end, ///< Something other than whitespace follows a value which must end the input.
     } what; ///< Type of error.
 
     doc_location location;
@@ -36,16 +41,57 @@ inline std::string_view enum_string(parse_error::kind what)
         "Expected ',' or ']' here to denote the next entry or the end of the array.",
         "Invalid new-line in string literal.",
         "Invalid character in string literal.",
-        "Invalid escape sequence in string literal."
+        "Invalid escape sequence in string literal.",
+        "Expected end of input after the value.",
     };
 
+    static_assert(std::size(msgs) == unsigned(parse_error::kind::expected_end) + 1, "Message missing for parse_error::kind.");
     return msgs[unsigned(what)];
 }
 #endif
 
 using parse_error_handler = std::function<void(const parse_error&)>;
 
+/// Optional settings for the parser.
+struct input_options
+{
+    /// Locates all structural characters and string boundaries with SIMD in a first pass, so the parser
+    /// can jump between tokens. Speeds up documents with long strings or much indentation.
+    bool structural_index = false;
+
+    /// Tracks only byte offsets while parsing. Lines of locations are computed on demand from a new-line index,
+    /// which is built once for the whole document when the first location is requested, e.g. on errors.
+    bool lazy_lines = false;
+
+    /// Arena which receives strings that have to be unescaped, instead of allocating each on the heap. Strings
+    /// obtained from the input are then only valid until the arena is reset, which it is not by the parser.
+    arena *strings = nullptr;
+};
+
+/// Optional settings for the parser when reading the document in chunks.
+struct stream_options
+{
+    size_t chunk_size = 64 * 1024; ///< Number of bytes read at once.
+    arena *strings = nullptr; ///< Like input_options::strings.
+};
+
 /// Parses the given source. On error, calls the specified handler and tries to uncover more errors.
-std::unique_ptr<doc_input> input(std::string_view source, parse_error_handler handler);
+std::unique_ptr<doc_input> input(std::string_view source, parse_error_handler handler, input_options options = {});
+
+/// Parses the given writable source like input(), but unescapes strings in place by overwriting their escape
+/// sequences, so no string is copied. The source must stay alive and must not be read as JSON again afterwards.
+/// input_options::strings and input_options::lazy_lines are not used, lines are always counted while parsing.
+std::unique_ptr<doc_input> input_mutable(char *source, size_t size, parse_error_handler handler, input_options options = {});
+
+/// Parses the file specified by its path, which is memory-mapped when possible and read into memory otherwise.
+/// Returns nullptr if the file cannot be opened.
+std::unique_ptr<doc_input> input_from_file(const std::string &path, parse_error_handler handler, input_options options = {}, map_options mapping = {});
+
+/// Parses the document provided by the reader, which is read in chunks of fixed size.
+/// Memory usage is bounded by the chunk size plus the size of the largest token. Strings obtained from the
+/// input only stay valid until the next call to next_token().
+/// On error, calls the specified handler and tries to uncover more errors, skipping from the position of the error
+/// instead of from the begin of the errorneous object or array, as that was discarded already.
+std::unique_ptr<doc_input> input(chunk_reader reader, parse_error_handler handler, stream_options options = {});
 
 }
\ No newline at end of file
@@ -0,0 +1,348 @@
+#pragma once
+
+///
+/// \file
+/// \brief Defines lines_reader for reading newline-delimited JSON (JSON Lines, NDJSON) on several threads.
+///
+/// Each line is a separate document. The file is cut into batches of whole lines, which worker threads read with one
+/// reused parser each. Values and errors of a batch are collected and handed to the caller on its own thread, so
+/// handlers and callbacks never run concurrently.
+///
+
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <variant>
+#include <optional>
+#include <exception>
+#include <algorithm>
+#include <string_view>
+#include <system_error>
+#include <condition_variable>
+
+#include "json_parser.hpp"
+#include "simd_utilities.hpp"
+
+namespace stc::json
+{
+
+/// Optional settings for lines_reader and read_json_lines().
+struct lines_options
+{
+    unsigned threads = 0; ///< Number of worker threads, or as many as the hardware supports when 0. With 1, lines are read on the calling thread.
+    bool ordered = true; ///< Whether values are delivered in the order of their lines, otherwise as soon as their batch is read.
+    size_t batch_size = 64 * 1024; ///< Bytes of lines handed to a worker at once, extended to the end of the last line.
+    size_t max_batches = 0; ///< Batches read ahead of the caller, which bound the memory of pending values. 4 per thread when 0.
+    input_options input; ///< Options of the parsers. input_options::strings is not used, as workers must not share an arena.
+
+    /// Prototype of the context each line is consumed with. Its error_handler is replaced, and document_outlives_values
+    /// is always set, as the source outlives the reader. When doc_context::strings or doc_context::objects is set, all
+    /// lines are read on the calling thread, as neither pools nor arenas are thread-safe.
+    doc_context context;
+};
+
+/// Value read from one line.
+template<class T>
+struct line_value
+{
+    T value;
+    unsigned line; ///< Line number, starting with 1 like doc_location::line.
+};
+
+namespace detail
+{
+
+/// Returns a pointer to the first new-line, or \p end if there is none.
+inline const char *find_newline(const char *ptr, const char *end)
+{
+    while(end - ptr >= std::ptrdiff_t(simd_block::size))
+    {
+        if(std::uint64_t newlines = simd_block(ptr).equal('\n'); newlines != 0)
+            return ptr + trailing_zeros(newlines);
+
+        ptr += simd_block::size;
+    }
+
+    while(ptr != end && *ptr != '\n')
+        ptr++;
+
+    return ptr;
+}
+
+/// Counts the new-lines within [ptr, end).
+inline size_t count_newlines(const char *ptr, const char *end)
+{
+    size_t count = 0;
+    for(; end - ptr >= std::ptrdiff_t(simd_block::size); ptr += simd_block::size)
+        count += popcount(simd_block(ptr).equal('\n'));
+
+    return count + size_t(std::count(ptr, end, '\n'));
+}
+
+} //end of detail
+
+
+/// Reads a newline-delimited JSON document, where each line holds one value of type T, on several threads.
+/// Lines which are empty or only contain whitespaces are ignored, anything but whitespace after the value of a line
+/// is reported as parse_error::kind::expected_end. Errors are reported with the location within the
+/// whole document, only skip the erroneous line and are passed to the handlers by next() on the calling thread, in
+/// order with the values when lines_options::ordered is set.
+/// The source must outlive the reader, as must strings which reference it. std::string_view members reference the
+/// source, strings with escape sequences in them are reported as value_not_referenceable. Consumers of T must not
+/// depend on shared state which is not thread-safe, see lines_options::context. Requires linking the threading library of the platform, e.g. Threads::Threads.
+template<class T>
+class lines_reader
+{
+public:
+    lines_reader(std::string_view source, parse_error_handler parse_handler, doc_error_handler consume_handler, lines_options options = {}) :
+        source(source), parse_handler(std::move(parse_handler)), consume_handler(std::move(consume_handler)), options(options)
+    {
+        this->options.input.strings = nullptr;
+        this->options.batch_size = std::max(this->options.batch_size, size_t(1));
+
+        unsigned threads = options.threads != 0 ? options.threads : std::max(std::thread::hardware_concurrency(), 1u);
+        if(options.context.strings != nullptr || options.context.objects != nullptr)
+            threads = 1;
+
+        if(this->options.max_batches == 0)
+            this->options.max_batches = size_t(4) * threads;
+
+        if(threads > 1)
+        {
+            workers.reserve(threads);
+            for(unsigned i = 0; i < threads; ++i)
+            {
+                try
+                {
+                    workers.emplace_back([this] { work(); });
+                }
+                catch(const std::system_error&) //continue with the threads that could be started
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    lines_reader(const lines_reader&) = delete;
+    lines_reader &operator=(const lines_reader&) = delete;
+
+    ~lines_reader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        room_available.notify_all();
+        for(std::thread &worker : workers)
+            worker.join();
+    }
+
+    /// Returns the next value, after passing the errors of the lines before it to the handlers. Returns nullopt once
+    /// all lines were read. Rethrows exceptions which consume() functions threw on a worker, other than for errors.
+    std::optional<line_value<T>> next()
+    {
+        while(true)
+        {
+            if(current)
+            {
+                while(position < current->events.size())
+                {
+                    auto &event = current->events[position++];
+                    if(auto *value = std::get_if<line_value<T>>(&event))
+                        return std::move(*value);
+
+                    if(auto *error = std::get_if<parse_error>(&event))
+                        parse_handler(*error);
+                    else
+                        consume_handler(std::get<doc_error>(event));
+                }
+
+                current.reset();
+            }
+
+            current = take_batch();
+            position = 0;
+            if(!current)
+                return std::nullopt;
+
+            if(current->exception)
+                std::rethrow_exception(std::exchange(current->exception, nullptr));
+        }
+    }
+
+private:
+    using event = std::variant<line_value<T>, parse_error, doc_error>;
+
+    /// Range of whole lines which is read at once.
+    struct batch
+    {
+        size_t begin;
+        size_t end;
+        unsigned first_line;
+        unsigned lines; ///< Number of new-lines within the batch.
+        bool done = false;
+        std::vector<event> events; ///< Values and errors in the order of their lines.
+        std::exception_ptr exception;
+    };
+
+    std::string_view source;
+    parse_error_handler parse_handler;
+    doc_error_handler consume_handler;
+    lines_options options;
+
+    std::mutex mutex;
+    std::condition_variable room_available; ///< Signaled when a batch was taken by the caller or when stopping.
+    std::condition_variable batch_done;
+    std::deque<std::unique_ptr<batch>> pending; ///< Claimed batches not yet taken by the caller, in the order of the document.
+    size_t scanned = 0; ///< Offset up to which the source was divided into batches.
+    unsigned scanned_lines = 1; ///< Line number at the offset.
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    std::unique_ptr<batch> current; ///< Batch whose events are being delivered.
+    size_t position = 0;
+    std::unique_ptr<parser> caller_parser; ///< Reads batches on the calling thread when there are no workers.
+
+    /// Divides off the next batch, which must be called with the mutex locked. Returns nullptr at the end.
+    batch *claim_batch()
+    {
+        if(scanned == source.size())
+            return nullptr;
+
+        size_t end = std::min(source.size(), scanned + options.batch_size);
+        end = detail::find_newline(source.data() + end - 1, source.data() + source.size()) - source.data();
+        end = std::min(end + 1, source.size());
+
+        auto claimed = std::make_unique<batch>();
+        claimed->begin = scanned;
+        claimed->end = end;
+        claimed->first_line = scanned_lines;
+        claimed->lines = unsigned(detail::count_newlines(source.data() + scanned, source.data() + end));
+
+        scanned_lines += claimed->lines;
+        scanned = end;
+        pending.push_back(std::move(claimed));
+        return pending.back().get();
+    }
+
+    /// Waits for the next batch to deliver and removes it from the pending ones, or reads it when there are no workers.
+    std::unique_ptr<batch> take_batch()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while(true)
+        {
+            auto found = pending.begin();
+            if(!options.ordered)
+                found = std::find_if(pending.begin(), pending.end(), [](const auto &b) { return b->done; });
+
+            if(found != pending.end() && (*found)->done)
+            {
+                std::unique_ptr<batch> taken = std::move(*found);
+                pending.erase(found);
+                lock.unlock();
+                room_available.notify_one();
+                return taken;
+            }
+
+            if(pending.empty() && scanned == source.size())
+                return nullptr;
+
+            if(workers.empty())
+            {
+                batch *claimed = claim_batch();
+                lock.unlock();
+                read_batch(*claimed, local_parser());
+                lock.lock();
+                claimed->done = true;
+                continue;
+            }
+
+            batch_done.wait(lock);
+        }
+    }
+
+    parser &local_parser()
+    {
+        if(!caller_parser)
+            caller_parser = std::make_unique<parser>(std::string_view(), nullptr, options.input);
+
+        return *caller_parser;
+    }
+
+    void work()
+    {
+        parser input(std::string_view(), nullptr, options.input);
+        std::unique_lock<std::mutex> lock(mutex);
+        while(true)
+        {
+            room_available.wait(lock, [&] { return stopping || scanned == source.size() || pending.size() < options.max_batches; });
+            if(stopping || scanned == source.size())
+                return;
+
+            batch *claimed = claim_batch();
+            lock.unlock();
+            read_batch(*claimed, input);
+            lock.lock();
+
+            claimed->done = true;
+            batch_done.notify_one();
+        }
+    }
+
+    /// Reads all lines of the batch, collecting values and errors.
+    void read_batch(batch &b, parser &input)
+    {
+        try
+        {
+            b.events.reserve(b.lines + 1);
+            input.error_handler = [&b](const parse_error &error) { b.events.emplace_back(error); };
+            doc_context context = options.context;
+            context.error_handler = [&b](const doc_error &error) { b.events.emplace_back(error); };
+            context.document_outlives_values = true;
+
+            const char *end = source.data() + b.end;
+            unsigned line = b.first_line;
+            for(const char *ptr = source.data() + b.begin; ptr < end; ++line)
+            {
+                const char *line_end = detail::find_newline(ptr, end);
+                std::string_view text(ptr, line_end - ptr);
+                ptr = line_end == end ? end : line_end + 1;
+
+                //blank lines yield neither a value nor an error, values must be followed by the end of their line
+                input.restart(text, text.data() - source.data(), line);
+                if(std::optional<T> value = from_input_with_context<T>(input, context); value && input.expect_end())
+                    b.events.emplace_back(line_value<T>{ std::move(*value), line });
+            }
+        }
+        catch(...)
+        {
+            b.exception = std::current_exception();
+        }
+    }
+};
+
+
+/// Reads a newline-delimited JSON document with lines_reader and calls \p on_value with each value and its line
+/// number on the calling thread. Returns the number of values.
+template<class T, class Fn>
+size_t read_json_lines(std::string_view source, Fn &&on_value, parse_error_handler parse_handler, doc_error_handler consume_handler, lines_options options = {})
+{
+    lines_reader<T> reader(source, std::move(parse_handler), std::move(consume_handler), options);
+
+    size_t count = 0;
+    while(std::optional<line_value<T>> value = reader.next())
+    {
+        on_value(std::move(value->value), value->line);
+        count++;
+    }
+
+    return count;
+}
+
+}
@@ -0,0 +1,281 @@
+#pragma once
+
+///
+/// \file
+/// \brief Defines from_json_parallel() for reading documents which consist of one large array on several threads.
+///
+/// A first pass over the array locates commas between its elements without tokenizing, 64 bytes at a time like
+/// skip_raw_container(). The array is split at these commas into parts of similar size, whose elements are consumed
+/// by separate parsers on separate threads and finally concatenated in order.
+///
+
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <iterator>
+#include <exception>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+#include <system_error>
+
+#include "json_parser.hpp"
+
+namespace stc::json
+{
+
+namespace detail
+{
+
+/// Parts of an array are not made smaller than this, as starting a thread only pays off for enough work.
+static constexpr size_t min_parallel_part = 64 * 1024;
+
+/// Comma which separates two elements of the outermost array.
+struct element_separator
+{
+    size_t offset; ///< Byte offset of the comma within the scanned source.
+    std::uint32_t lines; ///< Number of new-lines before the comma.
+};
+
+/// Splits the elements of an array, which start at \p source just after its [, into \p parts of similar size.
+/// Returns the first top-level comma at or after each multiple of the part size, so at most parts - 1 separators,
+/// fewer when the array ends earlier. Does not validate anything, invalid documents yield arbitrary separators.
+inline std::vector<element_separator> find_element_separators(std::string_view source, size_t parts)
+{
+    std::vector<element_separator> separators;
+    separators.reserve(parts);
+
+    size_t part_size = source.size() / parts;
+    size_t target = part_size; //offset at which the next part may begin
+    std::uint32_t lines = 0;
+    raw_skip_state state;
+
+    //returns whether the array ended
+    auto visit = [&](size_t offset, char ch, std::uint32_t lines_before)
+    {
+        if(ch == '{' || ch == '[')
+        {
+            state.depth++;
+        }
+        else if(ch == '}' || ch == ']')
+        {
+            return --state.depth == 0;
+        }
+        else if(state.depth == 1 && offset >= target)
+        {
+            separators.push_back(element_separator{ offset, lines_before });
+            target = std::max(offset + 1, target + part_size);
+            if(separators.size() + 1 == parts)
+                target = source.size(); //no more separators wanted
+        }
+
+        return false;
+    };
+
+    const char *ptr = source.data();
+    const char *end = ptr + source.size();
+    while(end - ptr >= std::ptrdiff_t(simd_block::size) && target < source.size())
+    {
+        simd_block block(ptr);
+        std::uint64_t quotes = block.equal('"') & ~find_escaped(block.equal('\\'), state.escaped);
+        std::uint64_t in_string = prefix_xor(quotes) ^ state.inside_string;
+        state.inside_string = std::uint64_t(0) - (in_string >> 63);
+
+        std::uint64_t opens = (block.equal('{') | block.equal('[')) & ~in_string;
+        std::uint64_t closes = (block.equal('}') | block.equal(']')) & ~in_string;
+        std::uint64_t commas = block.equal(',') & ~in_string;
+        std::uint64_t newlines = block.equal('\n');
+
+        size_t offset = ptr - source.data();
+        if(offset + simd_block::size > target || popcount(closes) >= state.depth) //visit each bracket and comma in order
+        {
+            for(std::uint64_t structurals = opens | closes | commas; structurals != 0; structurals &= structurals - 1)
+            {
+                unsigned pos = trailing_zeros(structurals);
+                std::uint32_t lines_before = lines + popcount(newlines & ((std::uint64_t(1) << pos) - 1));
+                if(visit(offset + pos, ptr[pos], lines_before))
+                    return separators;
+            }
+        }
+        else
+        {
+            state.depth += popcount(opens);
+            state.depth -= popcount(closes);
+        }
+
+        lines += popcount(newlines);
+        ptr += simd_block::size;
+    }
+
+    for(; ptr != end && target < source.size(); ++ptr)
+    {
+        char ch = *ptr;
+        if(state.escaped)
+            state.escaped = 0;
+        else if(ch == '\\')
+            state.escaped = 1;
+        else if(ch == '"')
+            state.inside_string = ~state.inside_string;
+        else if(!state.inside_string && (ch == '{' || ch == '[' || ch == '}' || ch == ']' || ch == ',') && visit(ptr - source.data(), ch, lines))
+            return separators;
+
+        if(ch == '\n')
+            lines++;
+    }
+
+    return separators;
+}
+
+/// Consumes the elements of the part of an array which \p input was created for. The first part begins after the [,
+/// every other one with the separating comma. Parts but the last end before the next separator, the last one ends
+/// with the ]. Returns false on errors, which are reported to the handlers of \p input and \p context.
+template<class T>
+bool consume_elements(parser &input, bool first, bool last, std::vector<T> &elements, const doc_context &context)
+{
+    input.call_stack.push_back(parser::stack_entry{ input.source.data(), parser::parse_state::eof, input.line });
+    input.state = first ? parser::parse_state::first_array_entry : parser::parse_state::next_array_entry;
+    try
+    {
+        for(size_t count = 0;; ++count)
+        {
+            input.skip_whitespaces();
+            if(!last && count > 0 && input.source.empty())
+                return true;
+
+            input.expect_input();
+            doc_input::token_kind token = input.next_token();
+            if(token == doc_input::token_kind::end_array)
+                return true;
+
+            elements.emplace_back(consume(type_wrap<T>(), token, input, context));
+        }
+    }
+    catch(const doc_input_exception&)
+    {
+    }
+    catch(const doc_consume_exception&)
+    {
+    }
+
+    return false;
+}
+
+template<class T>
+struct is_std_vector : std::false_type {};
+
+template<class T, class Allocator>
+struct is_std_vector<std::vector<T, Allocator>> : std::true_type {};
+
+} //end of detail
+
+
+/// Reads a document which consists of a single array like from_json<std::vector<T>>(), but splits the array into
+/// parts of elements which are consumed on up to \p threads threads, or as many as the hardware supports when 0.
+/// The result is identical to the one of from_json(). On errors, the document is read once more on the calling thread,
+/// so the handlers receive exactly the same errors as from from_json(), with correct locations. The handlers are only
+/// called from the calling thread.
+/// Documents which are small or not an array are read by from_json() directly. input_options::strings is only used
+/// then, as an arena must not be shared by several threads. Consumers of T must not depend on shared state which is
+/// not thread-safe. Requires linking the threading library of the platform, e.g. Threads::Threads with CMake.
+/// Each part is consumed with a copy of \p context whose error_handler does nothing. When doc_context::strings or
+/// doc_context::objects is set, the document is read serially by from_json_with_context(), as neither pools nor
+/// arenas are thread-safe.
+template<class Vector, class Context>
+std::optional<Vector> from_json_parallel_with_context(std::string_view source, unsigned threads, parse_error_handler parse_handler, Context &context, input_options options = {})
+{
+    static_assert(detail::is_std_vector<Vector>::value, "Only std::vector can be read in parallel.");
+
+    if(threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    size_t begin = 0;
+    while(begin < source.size() && is_whitespace(source[begin]))
+        begin++;
+
+    size_t parts = std::min(size_t(threads), source.size() / detail::min_parallel_part);
+    if(parts <= 1 || begin == source.size() || source[begin] != '[' || context.strings != nullptr || context.objects != nullptr)
+        return from_json_with_context<Vector>(source, std::move(parse_handler), context, options);
+
+    std::string_view elements = source.substr(begin + 1);
+    std::vector<detail::element_separator> separators = detail::find_element_separators(elements, parts);
+    std::uint32_t first_line = 1 + std::uint32_t(std::count(source.data(), elements.data(), '\n'));
+
+    size_t count = separators.size() + 1;
+    std::vector<Vector> results(count);
+    std::vector<char> succeeded(count, false);
+    std::vector<std::exception_ptr> exceptions(count);
+
+    input_options part_options = options;
+    part_options.strings = nullptr;
+    auto read_part = [&](size_t i)
+    {
+        try
+        {
+            size_t from = i == 0 ? 0 : separators[i - 1].offset;
+            size_t to = i + 1 == count ? elements.size() : separators[i].offset;
+
+            //errors are reported by the serial pass, so the parts need neither handlers nor error recovery
+            parser input(elements.substr(from, to - from), [](const parse_error&) {}, part_options);
+            input.source_offset = begin + 1 + from;
+            input.line = first_line + (i == 0 ? 0 : separators[i - 1].lines);
+            input.error_count = parser::max_errors;
+
+            Context part_context = context;
+            part_context.error_handler = [](const doc_error&) {};
+            succeeded[i] = detail::consume_elements(input, i == 0, i + 1 == count, results[i], part_context);
+        }
+        catch(...)
+        {
+            exceptions[i] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(count - 1);
+    for(size_t i = 1; i < count; ++i)
+    {
+        try
+        {
+            workers.emplace_back(read_part, i);
+        }
+        catch(const std::system_error&) //no more threads available, read the part on this thread
+        {
+            read_part(i);
+        }
+    }
+
+    read_part(0);
+    for(std::thread &worker : workers)
+        worker.join();
+
+    for(const std::exception_ptr &exception : exceptions)
+    {
+        if(exception)
+            std::rethrow_exception(exception);
+    }
+
+    if(std::find(succeeded.begin(), succeeded.end(), false) != succeeded.end())
+        return from_json_with_context<Vector>(source, std::move(parse_handler), context, options);
+
+    size_t total = 0;
+    for(const Vector &part : results)
+        total += part.size();
+
+    Vector result = std::move(results[0]);
+    result.reserve(total);
+    for(size_t i = 1; i < count; ++i)
+        std::move(results[i].begin(), results[i].end(), std::back_inserter(result));
+
+    return result;
+}
+
+/// Simple wrapper when not specifying a custom context.
+template<class Vector>
+std::optional<Vector> from_json_parallel(std::string_view source, unsigned threads, parse_error_handler parse_handler, doc_error_handler consume_handler, input_options options = {})
+{
+    doc_context context{ std::move(consume_handler) };
+    return from_json_parallel_with_context<Vector>(source, threads, std::move(parse_handler), context, options);
+}
+
+}
@@ -0,0 +1,968 @@
+#pragma once
+
+///
+/// \file
+/// \brief Defines the JSON parser itself, so consume() functions can be instantiated directly against it.
+///
+/// stc::json::input() hides the parser behind doc_input, which costs a virtual call for every token and accessor.
+/// from_json() instead passes the parser by its concrete type, so the compiler can inline the lexer into the consume()
+/// functions. Both paths parse identically.
+///
+
+#include <memory>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <variant>
+#include <optional>
+#include <algorithm>
+#include <string_view>
+
+#include "json_index.hpp"
+#include "arena.hpp"
+#include "json_input.hpp"
+#include "ref_string.hpp"
+#include "object_mapper.hpp"
+#include "simd_utilities.hpp"
+#include "parse_utilities.hpp"
+#include "number_utilities.hpp"
+
+namespace stc::json
+{
+
+namespace detail
+{
+
+/// Whether the specified character is invalid in JSON strings.
+inline bool is_control_char(char c)
+{
+    return c >= 0 && c < 32;
+}
+
+/// Replaces all escape sequences and writes the result to \p out, which must provide space for at least as many
+/// characters as \p string has, as unescaping never lengthens a string. Returns the end of the written string.
+/// \p out may point to the begin of \p string to unescape it in place.
+/// Runs without escape sequences are copied as a whole and unicode sequences are replaced by UTF-8 code-units.
+/// Leaves unknown escape sequences untouched.
+char *unescape_string(std::string_view string, char *out);
+
+/// Returns a pointer to the first backslash, quote or control character, or \p end if there is none.
+inline const char *find_string_stop(const char *ptr, const char *end)
+{
+    while(end - ptr >= std::ptrdiff_t(simd_block::size))
+    {
+        simd_block block(ptr);
+        if(std::uint64_t stops = block.equal('\\') | block.equal('"') | block.less(32); stops != 0)
+            return ptr + trailing_zeros(stops);
+
+        ptr += simd_block::size;
+    }
+
+    while(ptr != end && *ptr != '\\' && *ptr != '"' && !is_control_char(*ptr))
+        ptr++;
+
+    return ptr;
+}
+
+
+/// Parses the given JSON string, starting after the initial quote and stopping after the ending quote.
+/// Returns the string as it is written in the source and sets \p needs_escape when it contains escape sequences.
+inline std::variant<parse_error::kind, std::string_view> parse_string_literal(std::string_view &source, bool &needs_escape)
+{
+    const char *begin = source.data();
+    while(!source.empty())
+    {
+        const char *stop = find_string_stop(source.data(), source.data() + source.size()); //skip ordinary characters
+        source.remove_prefix(stop - source.data());
+
+        if(source.empty())
+            break;
+
+        char ch = source.front();
+        if(ch == '\n')
+            return parse_error::kind::string_invalid_newline;
+
+        if(is_control_char(ch))
+            return parse_error::kind::string_invalid_char;
+
+        if(ch == '\\')
+        {
+            needs_escape = true;
+            source.remove_prefix(1);
+            if(!source.empty() && !is_control_char(source.front())) //escaped character, possibly a quote
+                source.remove_prefix(1);
+
+            continue;
+        }
+
+        if(ch == '"')
+        {
+            std::string_view all(begin, source.data() - begin);
+            source.remove_prefix(1);
+            return all;
+        }
+    }
+
+    return parse_error::kind::eof_unexpected;
+}
+
+
+/// State of skip_container(), so skipping can be resumed when more input becomes available.
+struct container_skip_state
+{
+    size_t level = 0;
+    bool inside_string = false;
+    char last_char = 0;
+};
+
+/// Skips to the next ] or } on the same level of parentheses/string quotes.
+/// Returns whether the end of the container was reached.
+template<class LineT>
+bool skip_container(std::string_view &source, LineT &line, container_skip_state &state)
+{
+    auto &[level, inside_string, last_char] = state;
+    while(!source.empty())
+    {
+        char c = source.front();
+        if(level == 0 && (c == ']' || c == '}'))
+        {
+            source.remove_prefix(1);
+            return true;
+        }
+
+        switch(c)
+        {
+            case '[':
+            case '{': level++; break;
+
+            case ']':
+            case '}':
+                if(!inside_string)
+                    level--;
+                break;
+
+            case '"':
+                if(last_char != '\\')
+                    inside_string = !inside_string;
+                break;
+
+
+            case '\n':
+                line++;
+                if(inside_string)
+                    inside_string = false; //always terminate string literals at end of line
+                break;
+        }
+
+        last_char = source.front();
+        source.remove_prefix(1);
+    }
+
+    return false;
+}
+
+
+/// State of skip_raw_container(), so skipping can be resumed when more input becomes available.
+struct raw_skip_state
+{
+    size_t depth = 1; ///< Number of containers which are still open.
+    std::uint64_t inside_string = 0; ///< All ones while within a string literal.
+    std::uint64_t escaped = 0; ///< One when the next byte is escaped by a backslash.
+};
+
+/// Skips past the ] or } which closes the current container, without validating anything in between.
+/// Unlike skip_container(), which recovers from errors, escape sequences are fully respected.
+/// Whole blocks are skipped at once when they do not contain enough closing brackets to end the container.
+/// Returns whether the end of the container was reached.
+template<class LineT>
+bool skip_raw_container(std::string_view &source, LineT &line, raw_skip_state &state)
+{
+    const char *ptr = source.data();
+    const char *end = ptr + source.size();
+    while(end - ptr >= std::ptrdiff_t(simd_block::size))
+    {
+        simd_block block(ptr);
+        std::uint64_t quotes = block.equal('"') & ~find_escaped(block.equal('\\'), state.escaped);
+        std::uint64_t in_string = prefix_xor(quotes) ^ state.inside_string;
+        state.inside_string = std::uint64_t(0) - (in_string >> 63);
+
+        std::uint64_t opens = (block.equal('{') | block.equal('[')) & ~in_string;
+        std::uint64_t closes = (block.equal('}') | block.equal(']')) & ~in_string;
+        std::uint64_t newlines = block.equal('\n');
+
+        if(popcount(closes) >= state.depth) //container may end within this block
+        {
+            for(std::uint64_t brackets = opens | closes; brackets != 0; brackets &= brackets - 1)
+            {
+                unsigned pos = trailing_zeros(brackets);
+                if(opens >> pos & 1)
+                {
+                    state.depth++;
+                }
+                else if(--state.depth == 0)
+                {
+                    line += popcount(newlines & (~std::uint64_t(0) >> (63 - pos)));
+                    source.remove_prefix(ptr + pos + 1 - source.data());
+                    return true;
+                }
+            }
+        }
+        else
+        {
+            state.depth += popcount(opens);
+            state.depth -= popcount(closes);
+        }
+
+        line += popcount(newlines);
+        ptr += simd_block::size;
+    }
+
+    for(; ptr != end; ++ptr)
+    {
+        char ch = *ptr;
+        if(ch == '\n')
+            line++;
+
+        //like within blocks, a backslash only escapes quotes, so invalid brackets after one outside strings still count
+        bool escaped = state.escaped != 0;
+        state.escaped = 0;
+        if(ch == '\\' && !escaped)
+            state.escaped = 1;
+        else if(ch == '"' && !escaped)
+            state.inside_string = ~state.inside_string;
+        else if(state.inside_string)
+            continue;
+        else if(ch == '{' || ch == '[')
+            state.depth++;
+        else if((ch == '}' || ch == ']') && --state.depth == 0)
+        {
+            source.remove_prefix(ptr + 1 - source.data());
+            return true;
+        }
+    }
+
+    source.remove_prefix(source.size());
+    return false;
+}
+
+/// Number of bytes which the parser scans ahead at most to count the elements of a container.
+static constexpr size_t max_count_lookahead = 1024;
+
+/// Counts the elements of the array or the entries of the object which begins at \p source, just after its [ or {
+/// and whitespaces, by counting the commas on its outermost level like skip_raw_container(). Does not validate
+/// anything. Returns nullopt if the container does not end within the source.
+inline std::optional<size_t> count_elements(std::string_view source)
+{
+    if(source.empty())
+        return std::nullopt;
+
+    if(source.front() == ']' || source.front() == '}')
+        return 0;
+
+    size_t commas = 0;
+    raw_skip_state state;
+    const char *ptr = source.data();
+    const char *end = ptr + source.size();
+    while(end - ptr >= std::ptrdiff_t(simd_block::size))
+    {
+        simd_block block(ptr);
+        std::uint64_t quotes = block.equal('"') & ~find_escaped(block.equal('\\'), state.escaped);
+        std::uint64_t in_string = prefix_xor(quotes) ^ state.inside_string;
+        state.inside_string = std::uint64_t(0) - (in_string >> 63);
+
+        std::uint64_t opens = (block.equal('{') | block.equal('[')) & ~in_string;
+        std::uint64_t closes = (block.equal('}') | block.equal(']')) & ~in_string;
+        std::uint64_t separators = block.equal(',') & ~in_string;
+
+        if((opens | closes) == 0) //depth stays the same within the whole block
+        {
+            if(state.depth == 1)
+                commas += popcount(separators);
+        }
+        else if(state.depth > 1 && popcount(closes) < state.depth - 1) //all commas are nested
+        {
+            state.depth += popcount(opens);
+            state.depth -= popcount(closes);
+        }
+        else
+        {
+            for(std::uint64_t structurals = opens | closes | separators; structurals != 0; structurals &= structurals - 1)
+            {
+                unsigned pos = trailing_zeros(structurals);
+                if(opens >> pos & 1)
+                    state.depth++;
+                else if(closes >> pos & 1)
+                {
+                    if(--state.depth == 0)
+                        return commas + 1;
+                }
+                else if(state.depth == 1)
+                    commas++;
+            }
+        }
+
+        ptr += simd_block::size;
+    }
+
+    for(; ptr != end; ++ptr)
+    {
+        char ch = *ptr;
+        bool escaped = state.escaped != 0;
+        state.escaped = 0;
+        if(ch == '\\' && !escaped)
+            state.escaped = 1;
+        else if(ch == '"' && !escaped)
+            state.inside_string = ~state.inside_string;
+        else if(state.inside_string)
+            continue;
+        else if(ch == '{' || ch == '[')
+            state.depth++;
+        else if((ch == '}' || ch == ']') && --state.depth == 0)
+            return commas + 1;
+        else if(ch == ',' && state.depth == 1)
+            commas++;
+    }
+
+    return std::nullopt;
+}
+
+} //end of detail
+
+
+/// Parses JSON document using recursive descent.
+/// Switches between different parse_* methods on each call to next_token() depending on its state and uses a
+/// stack to store information when entering arrays or objects.
+/// In case of an error, the current object or array is skipped, parsing is continued
+/// and more errors are detected.
+/// The implementations of doc_input are final, so calls through parser are resolved statically.
+struct parser : public doc_input
+{
+    static constexpr size_t max_errors = 16;
+
+    const char *source_begin;
+    size_t source_offset = 0; ///< Byte index of source_begin within the document.
+    std::string_view source;
+    parse_error_handler error_handler;
+    bool rewindable = true; ///< Whether the source before the current token is kept, so errorneous containers can be skipped from their begin.
+
+    std::optional<structural_index> index; ///< Engaged when using the structural index and no error occurred so far.
+    bool indexed; ///< Whether to use the structural index for each document.
+
+    bool lazy_lines;
+    mutable std::optional<newline_index> newlines; ///< Built on the first request of a location when counting lines lazily.
+
+    arena *strings; ///< Receives unescaped strings, or nullptr to allocate them on the heap.
+    bool unescape_in_place = false; ///< Whether strings are unescaped within the source, which must be writable then.
+
+    parser(std::string_view s, parse_error_handler e, const input_options &options = {}) :
+        source(s), error_handler(std::move(e)), indexed(options.structural_index), lazy_lines(options.lazy_lines), strings(options.strings)
+    {
+        source_begin = source.data();
+        call_stack.reserve(16);
+
+        if(indexed)
+            index.emplace(source);
+    }
+
+    /// Checks that only whitespace follows the root value which was read, otherwise reports expected_end to the error
+    /// handler and returns false.
+    bool expect_end()
+    {
+        skip_whitespaces();
+        if(source.empty())
+            return true;
+
+        error_handler({ parse_error::kind::expected_end, location_at(source.data(), line) });
+        return false;
+    }
+
+    /// Starts over with another document, keeping allocated memory. \p offset and \p first_line locate the document
+    /// within a larger file, for the reported locations.
+    void restart(std::string_view s, size_t offset = 0, std::uint32_t first_line = 1)
+    {
+        source = s;
+        source_begin = s.data();
+        source_offset = offset;
+        line = first_line;
+        state = parse_state::begin;
+        call_stack.clear();
+        error_count = 0;
+        token_begin = property_begin = value_begin = nullptr;
+        newlines.reset();
+
+        if(indexed)
+            index.emplace(source);
+        else
+            index.reset();
+    }
+
+    /// Makes more input available when the source was consumed. Returns false at the end of the document.
+    virtual bool refill()
+    {
+        return false;
+    }
+
+    std::uint32_t line = 1;
+
+    /// Determines the parse_* method called by the next call to next_token().
+    enum class parse_state : std::uint8_t
+    {
+        begin,
+        eof,
+        first_property,
+        next_property,
+        first_array_entry,
+        next_array_entry,
+    };
+
+    parse_state state = parse_state::begin;
+
+    struct stack_entry
+    {
+        const char *from;
+        parse_state state;
+        std::uint32_t line;
+    };
+
+    std::vector<stack_entry> call_stack;
+
+    const char *token_begin = nullptr; ///< Position at which the current call to next_token() started.
+    const char *property_begin = nullptr;
+    const char *value_begin = nullptr;
+    std::uint32_t property_line = 1; ///< Line of property_begin, unless counting lines lazily.
+    std::uint32_t value_line = 1; ///< Line of value_begin, unless counting lines lazily.
+
+    ref_string current_property;
+    ref_string current_string;
+    ref_string current_number;
+    lexed_number current_lexed; ///< Decoded value of current_number.
+    bool current_bool = false;
+
+    size_t error_count = 0;
+
+
+    /// Location of \p relative_to, which is on line \p line_at unless counting lines lazily. Lines are remembered
+    /// rather than counted back from the current position, as strings unescaped in place may contain new-lines.
+    doc_location location_at(const char *relative_to, std::uint32_t line_at) const
+    {
+        size_t byte = source_offset + (relative_to - source_begin);
+        if(lazy_lines)
+        {
+            if(!newlines)
+                newlines.emplace(std::string_view(source_begin, source.data() + source.size() - source_begin));
+
+            return doc_location{ byte, unsigned(line + newlines->count_before(relative_to - source_begin)) }; //line stays at the first one
+        }
+
+        return doc_location{ byte, line_at };
+    }
+
+    size_t offset() const
+    {
+        return source.data() - source_begin;
+    }
+
+    /// Skips whitespaces, jumping to the next structural when indexed.
+    void skip_whitespaces()
+    {
+        if(index && !source.empty() && is_whitespace(source.front()))
+        {
+            size_t skip = index->next_structural(offset()) - offset();
+            if(!lazy_lines)
+                line += std::uint32_t(std::count(source.data(), source.data() + skip, '\n'));
+
+            source.remove_prefix(skip);
+            return;
+        }
+
+        do
+        {
+            if(lazy_lines)
+            {
+                ignored_lines ignored;
+                stc::skip_whitespaces(source, ignored);
+            }
+            else
+            {
+                stc::skip_whitespaces(source, line);
+            }
+        } while(source.empty() && refill());
+    }
+
+    /// Skips to the end of the current container.
+    void skip_container()
+    {
+        detail::container_skip_state skip_state;
+        bool complete;
+        do
+        {
+            token_begin = source.data(); //skipped input is not needed anymore, refill() may discard it
+            property_begin = value_begin = nullptr;
+            if(lazy_lines)
+            {
+                ignored_lines ignored;
+                complete = detail::skip_container(source, ignored, skip_state);
+            }
+            else
+            {
+                complete = detail::skip_container(source, line, skip_state);
+            }
+        } while(!complete && refill());
+    }
+
+    /// Parses a string literal after the initial quote, directly jumping to the closing quote when indexed.
+    std::variant<parse_error::kind, ref_string> read_string_literal()
+    {
+        if(index)
+        {
+            size_t stop = index->next_string_stop(offset());
+            if(stop < offset() + source.size() && source_begin[stop] == '"') //no escape sequences or control characters
+            {
+                std::string_view all(source.data(), stop - offset());
+                source.remove_prefix(all.size() + 1);
+                return ref_string(all);
+            }
+        }
+
+        bool needs_escape = false;
+        auto result = detail::parse_string_literal(source, needs_escape);
+        auto *raw = std::get_if<std::string_view>(&result);
+        if(raw == nullptr)
+            return std::get<parse_error::kind>(result);
+
+        if(!needs_escape)
+            return ref_string(*raw);
+
+        return unescaped_string(*raw);
+    }
+
+    /// Unescapes a string literal within the source, either in place, into the arena or into a new ref_string, which
+    /// only allocates when the string is too long to be stored inline.
+    ref_string unescaped_string(std::string_view raw)
+    {
+        if(unescape_in_place)
+        {
+            if(index) //the rest of the string must be indexed before it is rewritten
+                index->next_structural(offset());
+
+            char *buffer = const_cast<char*>(raw.data());
+            return ref_string(std::string_view(buffer, detail::unescape_string(raw, buffer) - buffer));
+        }
+
+        if(strings != nullptr)
+        {
+            char *buffer = strings->allocate_chars(raw.size());
+            return ref_string(std::string_view(buffer, detail::unescape_string(raw, buffer) - buffer));
+        }
+
+        return ref_string::make(raw.size(), [&](char *buffer) { return detail::unescape_string(raw, buffer); });
+    }
+
+    void push_stack()
+    {
+        call_stack.emplace_back(stack_entry{ source.data(), state, line });
+    }
+
+    void pop_stack()
+    {
+        assert(!call_stack.empty());
+        state = call_stack.back().state;
+        call_stack.pop_back();
+    }
+
+    /// Reports the error, skips the errorneous container to detect more errors and throws doc_input_exception.
+    [[noreturn]] void raise_error(parse_error::kind what);
+
+    void expect_input()
+    {
+        if(source.empty())
+            raise_error(parse_error::kind::eof_unexpected);
+    }
+
+    token_kind parse_begin()
+    {
+        state = parse_state::eof;
+        skip_whitespaces();
+        return source.empty() ? parse_eof() : parse_any();
+    }
+
+    token_kind parse_eof()
+    {
+        return token_kind::eof;
+    }
+
+    token_kind parse_any()
+    {
+        skip_whitespaces();
+        expect_input();
+
+        value_begin = source.data();
+        value_line = line;
+
+        char ch = source.front();
+        if(ch == '{')
+            return parse_object();
+
+        if(ch == '[')
+            return parse_array();
+
+        if(ch == '"')
+            return parse_string();
+
+        if(source.substr(0, 4) == "true")
+            return parse_bool<true>();
+
+        if(source.substr(0, 5) == "false")
+            return parse_bool<false>();
+
+        if(source.substr(0, 4) == "null")
+            return parse_null();
+
+        return parse_number();
+    }
+
+    token_kind parse_object()
+    {
+        source.remove_prefix(1);
+        skip_whitespaces();
+        expect_input();
+
+        push_stack();
+        state = parse_state::first_property;
+        return token_kind::begin_mapping;
+    }
+
+    template<bool AllowEnd>
+    token_kind parse_property()
+    {
+        char ch = source.front();
+        if(AllowEnd && ch == '}')
+        {
+            value_begin = source.data();
+            value_line = line;
+            source.remove_prefix(1);
+            pop_stack();
+            return token_kind::end_mapping;
+        }
+
+        if(ch != '"')
+            raise_error(parse_error::kind::expected_key);
+
+        source.remove_prefix(1);
+        property_begin = source.data();
+        property_line = line;
+
+        auto string_result = read_string_literal();
+        if(auto *error = std::get_if<parse_error::kind>(&string_result); error != nullptr)
+            raise_error(*error);
+
+        current_property = std::move(*std::get_if<ref_string>(&string_result));
+
+        skip_whitespaces();
+        expect_input();
+
+        if(source.front() != ':')
+            raise_error(parse_error::kind::expected_colon);
+
+        source.remove_prefix(1);
+        state = parse_state::next_property;
+        return parse_any();
+    }
+
+    token_kind parse_next_property()
+    {
+        skip_whitespaces();
+        expect_input();
+
+        char ch = source.front();
+        if(ch != ',' && ch != '}')
+            raise_error(parse_error::kind::expected_separator);
+
+        if(ch == ',')
+        {
+            source.remove_prefix(1);
+            skip_whitespaces();
+            expect_input();
+            return parse_property<false>();
+        }
+
+        return parse_property<true>();
+
+    }
+
+    token_kind parse_array()
+    {
+        source.remove_prefix(1);
+        skip_whitespaces();
+        expect_input();
+
+        push_stack();
+        state = parse_state::first_array_entry;
+        return token_kind::begin_array;
+    }
+
+    template<bool AllowEnd>
+    token_kind parse_array_entry()
+    {
+        if(AllowEnd && source.front() == ']')
+        {
+            value_begin = source.data();
+            value_line = line;
+            source.remove_prefix(1);
+            pop_stack();
+            return token_kind::end_array;
+        }
+
+        state = parse_state::next_array_entry;
+        return parse_any();
+    }
+
+    token_kind parse_next_array_entry()
+    {
+        skip_whitespaces();
+        expect_input();
+
+        char ch = source.front();
+        if(ch != ',' && ch != ']')
+            raise_error(parse_error::kind::expected_separator);
+
+        if(ch == ',')
+        {
+            source.remove_prefix(1);
+            skip_whitespaces();
+            expect_input();
+            return parse_array_entry<false>();
+        }
+
+        return parse_array_entry<true>();
+    }
+
+    token_kind parse_string()
+    {
+        source.remove_prefix(1);
+
+        auto string_result = read_string_literal();
+        if(auto *error = std::get_if<parse_error::kind>(&string_result); error != nullptr)
+            raise_error(*error);
+
+        current_string = std::move(*std::get_if<ref_string>(&string_result));
+        return token_kind::string;
+    }
+
+    template<bool Value>
+    token_kind parse_bool()
+    {
+        source.remove_prefix(Value ? 4 : 5);
+        current_bool = Value;
+        return token_kind::boolean;
+    }
+
+    token_kind parse_null()
+    {
+        source.remove_prefix(4);
+        return token_kind::null;
+    }
+
+    token_kind parse_number()
+    {
+        const char *begin = source.data();
+        auto res = lex_number(source, current_lexed);
+        if(res == number_validation_result::eof)
+            raise_error(parse_error::kind::eof_unexpected);
+
+        else if(res == number_validation_result::invalid_char)
+            raise_error(parse_error::kind::string_invalid_char);
+
+        current_number = std::string_view(begin, source.data() - begin);
+        return token_kind::number;
+    }
+
+    //implementation of doc_input
+    doc_location location(relative_loc rel = relative_loc::value) const final
+    {
+        const char *relative_to = rel == relative_loc::value ? value_begin : property_begin;
+        assert(relative_to != nullptr);
+        return location_at(relative_to, rel == relative_loc::value ? value_line : property_line);
+    }
+
+    token_kind next_token() final
+    {
+        token_begin = source.data();
+        switch(state)
+        {
+            case parse_state::begin: return parse_begin();
+            case parse_state::eof: return parse_eof();
+            case parse_state::first_property: return parse_property<true>();
+            case parse_state::next_property: return parse_next_property();
+            case parse_state::first_array_entry: return parse_array_entry<true>();
+            case parse_state::next_array_entry: return parse_next_array_entry();
+        }
+
+        assert(false);
+        return token_kind::eof;
+    }
+
+    /// Hides doc_input::read_number_array() with a loop which goes from one number literal to the next without the
+    /// state dispatch of next_token() and without probing for the other kinds of literals first.
+    template<class Fn>
+    token_kind read_number_array(Fn &&on_number)
+    {
+        assert(state == parse_state::first_array_entry);
+        while(true)
+        {
+            token_begin = source.data();
+            if(state == parse_state::next_array_entry)
+            {
+                skip_whitespaces();
+                expect_input();
+
+                char ch = source.front();
+                if(ch != ',' && ch != ']')
+                    raise_error(parse_error::kind::expected_separator);
+
+                if(ch == ']')
+                    return parse_array_entry<true>();
+
+                source.remove_prefix(1);
+                skip_whitespaces();
+                expect_input();
+            }
+            else if(source.front() == ']')
+            {
+                return parse_array_entry<true>();
+            }
+
+            state = parse_state::next_array_entry;
+            char ch = source.front();
+            if(ch != '-' && (ch < '0' || ch > '9'))
+                return parse_any();
+
+            value_begin = source.data();
+            value_line = line;
+            parse_number();
+            on_number();
+        }
+    }
+
+    bool hint(token_kind) final
+    {
+        return false;
+    }
+
+    /// Counts the elements of containers which end within the next max_count_lookahead bytes. Larger ones are not
+    /// counted, as scanning them ahead costs more than growing them.
+    std::optional<size_t> element_count_hint() final
+    {
+        if(state != parse_state::first_array_entry && state != parse_state::first_property)
+            return std::nullopt;
+
+        return detail::count_elements(source.substr(0, detail::max_count_lookahead));
+    }
+
+    void skip_value(token_kind first) final
+    {
+        if(first != token_kind::begin_mapping && first != token_kind::begin_array)
+            return;
+
+        detail::raw_skip_state skip_state;
+        bool complete;
+        do
+        {
+            token_begin = source.data(); //skipped input is not needed anymore
+            if(lazy_lines)
+            {
+                ignored_lines ignored;
+                complete = detail::skip_raw_container(source, ignored, skip_state);
+            }
+            else
+            {
+                complete = detail::skip_raw_container(source, line, skip_state);
+            }
+        } while(!complete && refill());
+
+        if(!complete)
+            raise_error(parse_error::kind::eof_unexpected);
+
+        value_begin = source.data() - 1;
+        value_line = line;
+        pop_stack();
+    }
+
+    ref_string &&mapping_key() final
+    {
+        return std::move(current_property);
+    }
+
+    bool boolean() final
+    {
+        return current_bool;
+    }
+
+    ref_string &&raw_number() final
+    {
+        return std::move(current_number);
+    }
+
+    std::optional<std::int64_t> int64_value() final
+    {
+        return to_int64(current_lexed);
+    }
+
+    std::optional<std::uint64_t> uint64_value() final
+    {
+        return to_uint64(current_lexed);
+    }
+
+    std::optional<double> double_value() final
+    {
+        return to_double(current_lexed);
+    }
+
+    std::optional<float> float_value() final
+    {
+        return to_float(current_lexed);
+    }
+
+    ref_string &&string() final
+    {
+        return std::move(current_string);
+    }
+};
+
+
+/// Reads an object of some type from the given JSON source like from_input_with_context(), but calls the parser
+/// directly instead of through doc_input. Custom consume() functions taking doc_input still work.
+template<class T, class Context>
+std::optional<T> from_json_with_context(std::string_view source, parse_error_handler parse_handler, Context &context, input_options options = {})
+{
+    parser input(source, std::move(parse_handler), options);
+    return from_input_with_context<T>(input, context);
+}
+
+/// Simple wrapper when not specifying a custom context.
+template<class T>
+std::optional<T> from_json(std::string_view source, parse_error_handler parse_handler, doc_error_handler consume_handler, input_options options = {})
+{
+    doc_context context{ std::move(consume_handler) };
+    return from_json_with_context<T>(source, std::move(parse_handler), context, options);
+}
+
+/// Reads an object of some type from the given JSON source into \p target like from_input_into_with_context(), but
+/// calls the parser directly instead of through doc_input.
+template<class T, class Context>
+bool from_json_into_with_context(T &target, std::string_view source, parse_error_handler parse_handler, Context &context, input_options options = {})
+{
+    parser input(source, std::move(parse_handler), options);
+    return from_input_into_with_context(target, input, context);
+}
+
+/// Simple wrapper when not specifying a custom context.
+template<class T>
+bool from_json_into(T &target, std::string_view source, parse_error_handler parse_handler, doc_error_handler consume_handler, input_options options = {})
+{
+    doc_context context{ std::move(consume_handler) };
+    return from_json_into_with_context(target, source, std::move(parse_handler), context, options);
+}
+
+}
\ No newline at end of file
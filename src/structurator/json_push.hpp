@@ -0,0 +1,215 @@
+#pragma once
+
+///
+/// \file
+/// \brief Defines push_parser for reading JSON documents which arrive in fragments, e.g. from a network connection.
+///
+/// Fragments are passed to push_parser::feed() as they arrive. Each byte is scanned once for the end of the current
+/// root value, resuming the scan state of skip_raw_container() across fragments, so tokens and strings may be split
+/// anywhere. As soon as a root value is complete, it is consumed right away, directly from the fragment when it was
+/// not split. Only the incomplete rest of a fragment is buffered.
+///
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <functional>
+#include <string_view>
+
+#include "json_parser.hpp"
+#include "object_mapper.hpp"
+
+namespace stc::json
+{
+
+/// Reads a sequence of JSON documents of type T from fragments of arbitrary size. Documents may be separated by
+/// whitespaces or follow each other directly. Every complete document is passed to the document handler, empty when
+/// it was erroneous. Errors are located within all bytes fed so far. Strings referencing the input, like ref_string,
+/// only stay valid until the document handler returns.
+template<class T>
+class push_parser
+{
+public:
+    using document_handler = std::function<void(std::optional<T> &&document)>;
+
+    push_parser(document_handler on_document, parse_error_handler parse_handler, doc_error_handler consume_handler, input_options options = {}) :
+        on_document(std::move(on_document)), input(std::string_view(), std::move(parse_handler), options), context{ std::move(consume_handler) }
+    {
+    }
+
+    push_parser(const push_parser&) = delete;
+    push_parser &operator=(const push_parser&) = delete;
+
+    /// Reads the next fragment and consumes all documents it completes. Returns the number of these documents.
+    size_t feed(std::string_view fragment)
+    {
+        if(buffer.empty()) //scan the fragment in place and only keep what is left of it
+        {
+            size_t done = process(fragment.data(), fragment.size(), false);
+            buffer.assign(fragment.data() + done, fragment.data() + fragment.size());
+            return complete_count(done);
+        }
+
+        buffer.insert(buffer.end(), fragment.begin(), fragment.end());
+        size_t done = process(buffer.data(), buffer.size(), false);
+        buffer.erase(buffer.begin(), buffer.begin() + done);
+        return complete_count(done);
+    }
+
+    /// Ends the input, so an incomplete document at the end is consumed as it is, which reports an error unless it
+    /// is a number or literal. Returns the number of documents consumed. Afterwards, the parser may be fed again.
+    size_t finish()
+    {
+        size_t done = process(buffer.data(), buffer.size(), true);
+        buffer.clear();
+        return complete_count(done);
+    }
+
+    /// Number of bytes buffered from fragments, which belong to an incomplete document.
+    size_t buffered() const
+    {
+        return buffer.size();
+    }
+
+private:
+    enum class root_kind : std::uint8_t
+    {
+        none, ///< Not within a document.
+        container,
+        string,
+        scalar,
+    };
+
+    document_handler on_document;
+    parser input;
+    doc_context context;
+
+    std::vector<char> buffer; ///< Bytes of the current, incomplete document.
+    size_t buffer_offset = 0; ///< Byte offset of the buffer within all fed bytes.
+    std::uint32_t buffer_line = 1; ///< Line at the begin of the buffer.
+
+    root_kind root = root_kind::none;
+    size_t scanned = 0; ///< Number of bytes of the buffer which were already scanned.
+    std::uint32_t scanned_line = 1; ///< Line after the scanned bytes.
+    detail::raw_skip_state skip_state; ///< State of the scan when root is container.
+    bool escaped = false; ///< Whether the next byte is escaped when root is string.
+    size_t documents = 0;
+
+    /// Makes the scan position relative to the bytes which are not \p done yet and returns the number of documents
+    /// consumed since the last call.
+    size_t complete_count(size_t done)
+    {
+        scanned -= done;
+        buffer_offset += done;
+        return std::exchange(documents, 0);
+    }
+
+    /// Scans data from the position after the last scan, which is \p scanned within data that starts with the
+    /// incomplete document, and consumes completed documents. Returns the number of bytes before the first one that
+    /// is still incomplete, which are not needed anymore.
+    size_t process(const char *data, size_t size, bool at_end)
+    {
+        size_t begin = 0; //begin of the current document
+        std::uint32_t begin_line = buffer_line;
+        size_t pos = scanned;
+        std::uint32_t line = scanned_line;
+
+        while(true)
+        {
+            if(root == root_kind::none)
+            {
+                for(; pos < size && is_whitespace(data[pos]); ++pos)
+                {
+                    if(data[pos] == '\n')
+                        line++;
+                }
+
+                begin = pos;
+                begin_line = line;
+                if(pos == size)
+                    break;
+
+                char ch = data[pos++];
+                if(ch == '{' || ch == '[')
+                {
+                    root = root_kind::container;
+                    skip_state = detail::raw_skip_state();
+                }
+                else if(ch == '"')
+                {
+                    root = root_kind::string;
+                    escaped = false;
+                }
+                else
+                {
+                    root = root_kind::scalar;
+                }
+            }
+
+            if(!scan_document(data, size, pos, line))
+            {
+                if(!at_end)
+                    break;
+
+                pos = size;
+            }
+
+            consume_document(std::string_view(data + begin, pos - begin), buffer_offset + begin, begin_line);
+            root = root_kind::none;
+        }
+
+        scanned = pos;
+        scanned_line = line;
+        buffer_line = begin_line;
+        return begin;
+    }
+
+    /// Advances \p pos through the current document. Returns whether its end was reached, \p pos is after it then.
+    bool scan_document(const char *data, size_t size, size_t &pos, std::uint32_t &line)
+    {
+        if(root == root_kind::container)
+        {
+            std::string_view rest(data + pos, size - pos);
+            bool complete = detail::skip_raw_container(rest, line, skip_state);
+            pos = rest.data() - data;
+            return complete;
+        }
+
+        for(; pos < size; ++pos)
+        {
+            char ch = data[pos];
+            if(root == root_kind::string)
+            {
+                if(escaped)
+                    escaped = false;
+                else if(ch == '\\')
+                    escaped = true;
+                else if(ch == '"' || detail::is_control_char(ch)) //parser either finishes the string or stops there with an error
+                {
+                    if(ch == '\n')
+                        line++;
+
+                    pos++;
+                    return true;
+                }
+            }
+            else if(is_whitespace(ch) || std::strchr("{}[]:,\"", ch) != nullptr) //end of number or literal
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void consume_document(std::string_view document, size_t offset, std::uint32_t first_line)
+    {
+        input.restart(document, offset, first_line);
+        on_document(from_input_with_context<T>(input, context));
+        documents++;
+    }
+};
+
+}
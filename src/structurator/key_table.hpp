@@ -0,0 +1,226 @@
+#pragma once
+
+///
+/// \file
+/// \brief Defines perfect hash tables which are built at compile time and map a fixed set of keys to values.
+///
+/// Keys are distributed into buckets by their hash. For every bucket, a displacement is searched such that all of
+/// its keys land in free slots when re-mixing their hash with it ("hash and displace"). Looking up a key therefore
+/// costs a few loads, one hash and a single comparison, regardless of the number of keys.
+///
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace stc
+{
+
+namespace detail
+{
+
+/// Returns the byte at \p ptr shifted to position \p Index within a word.
+template<size_t Index>
+constexpr std::uint64_t key_byte(const char *ptr)
+{
+    return std::uint64_t((unsigned char)ptr[Index]) << (8 * Index);
+}
+
+/// Reads \p Count bytes (4 or 8) as little-endian integer without memcpy, so it works at compile time.
+/// Compilers merge the spelled out byte accesses into a single load.
+template<size_t Count>
+constexpr std::uint64_t read_key_word(const char *ptr)
+{
+    std::uint64_t word = key_byte<0>(ptr) | key_byte<1>(ptr) | key_byte<2>(ptr) | key_byte<3>(ptr);
+    if constexpr(Count == 8)
+        word |= key_byte<4>(ptr) | key_byte<5>(ptr) | key_byte<6>(ptr) | key_byte<7>(ptr);
+
+    return word;
+}
+
+/// Content of a key gathered with few, overlapping loads. Keys up to 16 bytes are represented exactly by their first
+/// and last (up to) eight bytes, so comparing the words and the size compares the keys.
+struct key_words
+{
+    std::uint64_t a = 0;
+    std::uint64_t b = 0;
+
+    constexpr bool operator==(const key_words &rhs) const
+    {
+        return a == rhs.a && b == rhs.b;
+    }
+};
+
+/// Keys longer than this are compared completely after their words matched.
+static constexpr size_t max_exact_key_size = 16;
+
+constexpr key_words read_key_words(std::string_view key)
+{
+    const char *ptr = key.data();
+    size_t size = key.size();
+
+    key_words words;
+    if(size >= 8)
+    {
+        for(size_t pos = 8; pos + 8 < size; pos += 8) //middle of long keys
+            words.a = (words.a ^ read_key_word<8>(ptr + pos)) * 0x9e3779b97f4a7c15ull;
+
+        words.a ^= read_key_word<8>(ptr);
+        words.b = read_key_word<8>(ptr + size - 8);
+    }
+    else if(size >= 4)
+    {
+        words.a = read_key_word<4>(ptr);
+        words.b = read_key_word<4>(ptr + size - 4);
+    }
+    else if(size > 0)
+    {
+        words.a = std::uint64_t((unsigned char)ptr[0]) | std::uint64_t((unsigned char)ptr[size / 2]) << 8 | std::uint64_t((unsigned char)ptr[size - 1]) << 16;
+    }
+
+    return words;
+}
+
+constexpr std::uint64_t hash_key(const key_words &words, size_t size)
+{
+    std::uint64_t hash = (words.a ^ 0xa0761d6478bd642full) * 0xe7037ed1a0b428dbull ^ (words.b ^ size) * 0x8ebc6af09c88c6e3ull;
+    return hash ^ hash >> 32;
+}
+
+/// Smallest power of two not less than \p n.
+constexpr size_t key_table_ceil2(size_t n)
+{
+    size_t size = 1;
+    while(size < n)
+        size *= 2;
+
+    return size;
+}
+
+} //end of detail
+
+
+/// Maps a fixed set of keys to values of type \p Value using a perfect hash.
+/// Use make_key_table() to build it at compile time.
+template<class Value, size_t Buckets, size_t Slots>
+struct key_table
+{
+    std::array<std::uint32_t, Buckets> displacements = {};
+    std::array<std::string_view, Slots> keys = {};
+    std::array<detail::key_words, Slots> words = {};
+    std::array<Value, Slots> values = {};
+    std::array<bool, Slots> used = {};
+
+    static constexpr size_t bucket_of(std::uint64_t hash)
+    {
+        return size_t(hash) & (Buckets - 1);
+    }
+
+    /// Uses the highest bits of the product, which depend on all bits of the hash.
+    static constexpr size_t slot_of(std::uint64_t hash, std::uint32_t displacement)
+    {
+        return size_t(((hash ^ displacement) * 0x9fb21c651e98df25ull) >> 32) & (Slots - 1);
+    }
+
+    /// Returns the value of the given key or nullptr when it is not part of the table.
+    constexpr const Value *find(std::string_view key) const
+    {
+        return find(key, detail::read_key_words(key));
+    }
+
+    /// Overload for keys of which the words were already read.
+    constexpr const Value *find(std::string_view key, const detail::key_words &key_words) const
+    {
+        std::uint64_t hash = detail::hash_key(key_words, key.size());
+        size_t slot = slot_of(hash, displacements[bucket_of(hash)]);
+        if(!used[slot] || keys[slot].size() != key.size() || !(words[slot] == key_words))
+            return nullptr;
+
+        if(key.size() > detail::max_exact_key_size && keys[slot] != key)
+            return nullptr;
+
+        return &values[slot];
+    }
+};
+
+
+/// Builds a key_table from the first \p count entries of \p keys and \p values. Keys must be unique.
+/// There are twice as many slots as possible keys, so suitable displacements are found after a few attempts.
+template<class Value, size_t N>
+constexpr auto make_key_table(const std::array<std::string_view, N> &keys, const std::array<Value, N> &values, size_t count = N)
+{
+    constexpr size_t buckets = detail::key_table_ceil2(N / 2 + 1);
+    constexpr size_t slots = detail::key_table_ceil2(2 * N);
+    using table_type = key_table<Value, buckets, slots>;
+
+    table_type table;
+
+    std::array<std::uint64_t, N> hashes = {};
+    std::array<size_t, buckets> bucket_sizes = {};
+    size_t max_bucket_size = 0;
+    for(size_t i = 0; i < count; ++i)
+    {
+        hashes[i] = detail::hash_key(detail::read_key_words(keys[i]), keys[i].size());
+        size_t &size = bucket_sizes[table_type::bucket_of(hashes[i])];
+        size++;
+        max_bucket_size = size > max_bucket_size ? size : max_bucket_size;
+    }
+
+    //place large buckets first while there are many free slots
+    for(size_t size = max_bucket_size; size > 0; --size)
+    {
+        for(size_t bucket = 0; bucket < buckets; ++bucket)
+        {
+            if(bucket_sizes[bucket] != size)
+                continue;
+
+            for(std::uint32_t displacement = 0; ; ++displacement)
+            {
+                if(displacement == 1u << 20)
+                    throw "No perfect hash found, keys are probably not unique.";
+
+                //check that the keys of the bucket land in distinct free slots
+                std::array<size_t, N> chosen = {};
+                size_t chosen_count = 0;
+                for(size_t i = 0; i < count && chosen_count < size; ++i)
+                {
+                    if(table_type::bucket_of(hashes[i]) != bucket)
+                        continue;
+
+                    size_t slot = table_type::slot_of(hashes[i], displacement);
+                    bool taken = table.used[slot];
+                    for(size_t j = 0; j < chosen_count && !taken; ++j)
+                        taken = chosen[j] == slot;
+
+                    if(taken)
+                        break;
+
+                    chosen[chosen_count++] = slot;
+                }
+
+                if(chosen_count != size)
+                    continue;
+
+                table.displacements[bucket] = displacement;
+                for(size_t i = 0; i < count; ++i)
+                {
+                    if(table_type::bucket_of(hashes[i]) != bucket)
+                        continue;
+
+                    size_t slot = table_type::slot_of(hashes[i], displacement);
+                    table.keys[slot] = keys[i];
+                    table.words[slot] = detail::read_key_words(keys[i]);
+                    table.values[slot] = values[i];
+                    table.used[slot] = true;
+                }
+
+                break;
+            }
+        }
+    }
+
+    return table;
+}
+
+}
\ No newline at end of file
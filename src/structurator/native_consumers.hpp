@@ -5,27 +5,24 @@
 /// \brief Defines consume() for reading built-in types from documents.
 ///
 
+#include <limits>
 #include <climits>
 #include <cstdint>
 #include <cassert>
 #include <charconv>
+#include <optional>
+#include <string_view>
 #include <type_traits>
 
-#if _MSC_VER >= 1924 || __GNUC__ >= 11
-#define STC_HAS_FLOAT_FROM_CHARS //supports std::from_chars with floats
-#else
-#include <cmath>
-#include <cstdlib> //uses std::stof as fallback
-#include <cstring>
-#endif
-
 #include "doc_consumer.hpp"
+#include "number_utilities.hpp"
 #include "arithmetic_utilities.hpp"
 
 namespace stc
 {
 
-inline bool consume(type_wrap<bool>, doc_input::token_kind first, doc_input &input, const doc_context &context)
+template<class Input>
+bool consume(type_wrap<bool>, doc_input::token_kind first, Input &input, const doc_context &context)
 {
     if(first != doc_input::token_kind::boolean && !input.hint(doc_input::token_kind::boolean))
     {
@@ -37,9 +34,9 @@ inline bool consume(type_wrap<bool>, doc_input::token_kind first, doc_input &inp
 }
 
 /// Integers and floats. Both may be specified using an exponent, but only floats may have fractional digits.
-template<class T>
+template<class T, class Input>
 std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>, T>
-        consume(type_wrap<T>, doc_input::token_kind first, doc_input &input, const doc_context &context)
+        consume(type_wrap<T>, doc_input::token_kind first, Input &input, const doc_context &context)
 {
     if(first != doc_input::token_kind::number && !input.hint(doc_input::token_kind::number))
     {
@@ -47,6 +44,28 @@ std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is
         throw doc_consume_exception();
     }
 
+    //use the value decoded by the input if available, otherwise convert the number's text
+    if constexpr(std::is_integral_v<T> && std::is_signed_v<T>)
+    {
+        if(std::optional<std::int64_t> value = input.int64_value(); value && *value >= std::numeric_limits<T>::min() && *value <= std::numeric_limits<T>::max())
+            return T(*value);
+    }
+    else if constexpr(std::is_integral_v<T>)
+    {
+        if(std::optional<std::uint64_t> value = input.uint64_value(); value && *value <= std::numeric_limits<T>::max())
+            return T(*value);
+    }
+    else if constexpr(std::is_same_v<T, float>)
+    {
+        if(std::optional<float> value = input.float_value())
+            return *value;
+    }
+    else if constexpr(std::is_same_v<T, double>)
+    {
+        if(std::optional<double> value = input.double_value())
+            return *value;
+    }
+
     ref_string n = input.raw_number();
     assert(n.size() > 0);
     const char *begin = n.data();
@@ -66,29 +85,7 @@ std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is
     }
     else
     {
-#ifdef STC_HAS_FLOAT_FROM_CHARS
-        error = std::from_chars(begin, end, value);
-#else
-        char tmp[64];
-        std::strncpy(tmp, begin, n.size() + 1);
-        tmp[63] = 0;
-        char *ptr;
-        if constexpr(std::is_same_v<T, float>)
-        {
-            value = std::strtof(tmp, &ptr);
-            error.ec = value == HUGE_VALF ? std::errc::result_out_of_range : std::errc();
-        }
-        else if constexpr(std::is_same_v<T, double>)
-        {
-            value = std::strtold(tmp, &ptr);
-            error.ec = value == HUGE_VAL ? std::errc::result_out_of_range : std::errc();
-        }
-        else if constexpr(std::is_same_v<T, long double>)
-        {
-            value = std::strtold(tmp, &ptr);
-            error.ec = value == HUGE_VALL ? std::errc::result_out_of_range : std::errc();
-        }
-#endif
+        error = float_from_chars(begin, end, value);
     }
 
     assert(error.ec != std::errc::invalid_argument);
@@ -128,7 +125,8 @@ std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is
 }
 
 /// Single character as a string of one code-unit.
-inline char consume(type_wrap<char>, doc_input::token_kind first, doc_input &input, const doc_context &context)
+template<class Input>
+char consume(type_wrap<char>, doc_input::token_kind first, Input &input, const doc_context &context)
 {
     if(first != doc_input::token_kind::string && !input.hint(doc_input::token_kind::string))
     {
@@ -147,7 +145,8 @@ inline char consume(type_wrap<char>, doc_input::token_kind first, doc_input &inp
 }
 
 
-inline ref_string consume(type_wrap<ref_string>, doc_input::token_kind first, doc_input &input, const doc_context &context)
+template<class Input>
+ref_string consume(type_wrap<ref_string>, doc_input::token_kind first, Input &input, const doc_context &context)
 {
     if(first != doc_input::token_kind::string && !input.hint(doc_input::token_kind::string))
     {
@@ -158,4 +157,27 @@ inline ref_string consume(type_wrap<ref_string>, doc_input::token_kind first, do
     return input.string();
 }
 
+/// Reads a string without copying it, referencing either the document or, when it had to be unescaped, the arena of
+/// the input (see json::input_options::strings) or the document itself when unescaped in place.
+/// Requires doc_context::document_outlives_values. Strings which were unescaped into a ref_string of their own cannot
+/// be referenced, as these are released with it, and are reported as value_not_referenceable.
+template<class Input>
+std::string_view consume(type_wrap<std::string_view>, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    if(first != doc_input::token_kind::string && !input.hint(doc_input::token_kind::string))
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::type_mismatch });
+        throw doc_consume_exception();
+    }
+
+    ref_string string = input.string();
+    if(!context.document_outlives_values || string.is_owned())
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::value_not_referenceable });
+        throw doc_consume_exception();
+    }
+
+    return string;
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,483 @@
+#pragma once
+
+///
+/// \file
+/// \brief Defines a lexer for decimal numbers which decodes them while validating, and conversions of the result.
+///
+/// The digits of a number are accumulated into an integer mantissa, eight at a time when possible (SWAR: parallel
+/// arithmetic on the bytes of a 64-bit word). Conversions to integers and floating-point numbers are exact and
+/// return nullopt when they cannot be done cheaply, so callers fall back to converting the raw text.
+///
+/// Floating-point numbers are converted with the Eisel-Lemire algorithm: the mantissa is multiplied by a 128-bit
+/// approximation of the power of ten, which determines the correctly rounded result unless it lies too close to a
+/// midpoint between two floats. Such rare cases, numbers with more than 19 digits and long doubles which are not
+/// exact after a single operation use an exact but slow conversion with arbitrary-precision decimals.
+///
+
+#include <cfloat>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <optional>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+
+#include "simd_utilities.hpp"
+#include "parse_utilities.hpp"
+#include "arithmetic_utilities.hpp"
+
+namespace stc
+{
+
+/// Decimal number as decoded by lex_number(): (negative ? -1 : 1) * mantissa * 10^exponent.
+struct lexed_number
+{
+    std::uint64_t mantissa = 0; ///< Integral and fractional digits without leading zeros.
+    std::int32_t exponent = 0; ///< Exponent, shifted by the number of fractional digits.
+    bool negative = false;
+    bool exact = true; ///< Whether the mantissa holds all digits, which is the case for up to 19 significant digits.
+    bool integral = true; ///< Written without fractional part and without negative exponent.
+};
+
+namespace detail
+{
+
+/// Reads eight characters as little-endian word.
+inline std::uint64_t read_digit_chunk(const char *ptr)
+{
+    std::uint64_t chunk;
+    std::memcpy(&chunk, ptr, sizeof(chunk));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    chunk = __builtin_bswap64(chunk);
+#endif
+    return chunk;
+}
+
+/// Whether all eight characters of the word are decimal digits: adding 6 to a digit must not carry into the high nibble.
+inline bool is_eight_digits(std::uint64_t chunk)
+{
+    return ((chunk & 0xF0F0F0F0F0F0F0F0ull) | (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+
+/// Converts eight digits by combining neighbouring pairs, quads and octets with one multiplication each.
+inline std::uint32_t parse_eight_digits(std::uint64_t chunk)
+{
+    chunk = ((chunk & 0x0F0F0F0F0F0F0F0Full) * 2561) >> 8;
+    chunk = ((chunk & 0x00FF00FF00FF00FFull) * 6553601) >> 16;
+    return std::uint32_t(((chunk & 0x0000FFFF0000FFFFull) * 42949672960001ull) >> 32);
+}
+
+/// Consumes all leading zeros and returns their number.
+inline size_t skip_zeros(std::string_view &source)
+{
+    size_t count = 0;
+    while(count < source.size() && source[count] == '0')
+        count++;
+
+    source.remove_prefix(count);
+    return count;
+}
+
+/// Consumes all leading digits and appends them to \p mantissa, which wraps around when there are too many digits.
+/// Returns the number of digits.
+inline size_t lex_digits(std::string_view &source, std::uint64_t &mantissa)
+{
+    const char *ptr = source.data();
+    const char *end = ptr + source.size();
+    while(end - ptr >= 8)
+    {
+        std::uint64_t chunk = read_digit_chunk(ptr);
+        if(!is_eight_digits(chunk))
+            break;
+
+        mantissa = mantissa * 100000000 + parse_eight_digits(chunk);
+        ptr += 8;
+    }
+
+    while(ptr != end && unsigned(*ptr - '0') < 10)
+        mantissa = mantissa * 10 + unsigned(*ptr++ - '0');
+
+    size_t count = ptr - source.data();
+    source.remove_prefix(count);
+    return count;
+}
+
+inline number_validation_result missing_digits(std::string_view source)
+{
+    return source.empty() ? number_validation_result::eof : number_validation_result::invalid_char;
+}
+
+static constexpr double exact_powers10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+static constexpr long double exact_powers10l[] = { 1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L, 1e12L, 1e13L, 1e14L,
+    1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L };
+
+/// Truncated 128-bit mantissas of the powers of five from 5^-342 to 5^308, normalized to a set highest bit,
+/// as pairs of high and low word.
+extern const std::uint64_t powers5_128[];
+static constexpr int smallest_power5 = -342;
+
+/// Bit layout of an IEEE 754 binary format and the ranges used by eisel_lemire().
+template<class T>
+struct binary_format;
+
+template<>
+struct binary_format<double>
+{
+    using bits_type = std::uint64_t;
+    static constexpr int mantissa_bits = 52; ///< Explicitly stored bits.
+    static constexpr int minimum_exponent = -1023;
+    static constexpr int infinite_power = 0x7FF;
+    static constexpr int min_round_to_even = -4; ///< Powers of ten for which products may lie exactly halfway.
+    static constexpr int max_round_to_even = 23;
+    static constexpr int smallest_power10 = -342; ///< Numbers with smaller powers are zero.
+    static constexpr int largest_power10 = 308; ///< Numbers with larger powers are infinite.
+};
+
+template<>
+struct binary_format<float>
+{
+    using bits_type = std::uint32_t;
+    static constexpr int mantissa_bits = 23;
+    static constexpr int minimum_exponent = -127;
+    static constexpr int infinite_power = 0xFF;
+    static constexpr int min_round_to_even = -17;
+    static constexpr int max_round_to_even = 10;
+    static constexpr int smallest_power10 = -65;
+    static constexpr int largest_power10 = 38;
+};
+
+struct uint128_parts
+{
+    std::uint64_t low;
+    std::uint64_t high;
+};
+
+inline uint128_parts multiply_full(std::uint64_t a, std::uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ using uint128 = unsigned __int128; //silences -Wpedantic
+    uint128 product = uint128(a) * b;
+    return { std::uint64_t(product), std::uint64_t(product >> 64) };
+#elif defined(_MSC_VER) && defined(_M_X64)
+    std::uint64_t high;
+    std::uint64_t low = _umul128(a, b, &high);
+    return { low, high };
+#else
+    std::uint64_t a_low = a & 0xFFFFFFFF, a_high = a >> 32;
+    std::uint64_t b_low = b & 0xFFFFFFFF, b_high = b >> 32;
+    std::uint64_t low_low = a_low * b_low;
+    std::uint64_t mid1 = a_high * b_low + (low_low >> 32);
+    std::uint64_t mid2 = a_low * b_high + (mid1 & 0xFFFFFFFF);
+    return { (mid2 << 32) | (low_low & 0xFFFFFFFF), a_high * b_high + (mid1 >> 32) + (mid2 >> 32) };
+#endif
+}
+
+/// Computes the float closest to \p mantissa * 10^\p power10 with the algorithm by Eisel and Lemire. Returns nullopt
+/// in the rare cases in which 128 bits of the power do not suffice to decide the rounding. Overflows to infinity.
+template<class T>
+std::optional<T> eisel_lemire(std::uint64_t mantissa, std::int32_t power10, bool negative)
+{
+    using format = binary_format<T>;
+    using bits_type = typename format::bits_type;
+    static_assert(std::numeric_limits<T>::is_iec559 && sizeof(T) == sizeof(bits_type));
+
+    std::uint64_t result = 0;
+    int power2 = 0; //biased exponent
+    if(mantissa == 0 || power10 < format::smallest_power10)
+    {
+    }
+    else if(power10 > format::largest_power10)
+    {
+        power2 = format::infinite_power;
+    }
+    else
+    {
+        //normalize the mantissa and multiply it with the power of five, the power of two only adds to the exponent
+        unsigned shift = leading_zeros(mantissa);
+        mantissa <<= shift;
+
+        const std::uint64_t *power = powers5_128 + 2 * (power10 - smallest_power5);
+        uint128_parts product = multiply_full(mantissa, power[0]);
+        static constexpr std::uint64_t precision_mask = ~std::uint64_t(0) >> (format::mantissa_bits + 3);
+        if((product.high & precision_mask) == precision_mask) //the truncated bits of the product may still carry
+        {
+            uint128_parts low_product = multiply_full(mantissa, power[1]);
+            product.low += low_product.high;
+            if(low_product.high > product.low)
+                product.high++;
+        }
+
+        if(product.low == ~std::uint64_t(0) && (power10 < -27 || power10 > 55)) //the error of the truncated power may matter
+            return std::nullopt;
+
+        //keep one bit more than the mantissa for rounding
+        int upper_bit = int(product.high >> 63);
+        int drop = upper_bit + 64 - format::mantissa_bits - 3;
+        result = product.high >> drop;
+        power2 = int(((152170 + 65536) * power10) >> 16) + 63 + upper_bit - int(shift) - format::minimum_exponent;
+
+        if(power2 <= 0) //subnormal
+        {
+            if(-power2 + 1 >= 64)
+            {
+                result = 0;
+                power2 = 0;
+            }
+            else
+            {
+                result >>= -power2 + 1;
+                result += result & 1;
+                result >>= 1;
+                power2 = result < (std::uint64_t(1) << format::mantissa_bits) ? 0 : 1;
+            }
+        }
+        else
+        {
+            //exactly halfway, round to even instead of up
+            if(product.low <= 1 && power10 >= format::min_round_to_even && power10 <= format::max_round_to_even &&
+                (result & 3) == 1 && (result << drop) == product.high)
+                result &= ~std::uint64_t(1);
+
+            result += result & 1;
+            result >>= 1;
+            if(result >= (std::uint64_t(2) << format::mantissa_bits)) //rounded up to the next power of two
+            {
+                result = std::uint64_t(1) << format::mantissa_bits;
+                power2++;
+            }
+
+            result &= ~(std::uint64_t(1) << format::mantissa_bits);
+            if(power2 >= format::infinite_power)
+            {
+                power2 = format::infinite_power;
+                result = 0;
+            }
+        }
+    }
+
+    bits_type bits = bits_type(result) | bits_type(power2) << format::mantissa_bits;
+    if(negative)
+        bits |= bits_type(1) << (sizeof(bits_type) * CHAR_BIT - 1);
+
+    T value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/// Converts the text of a number as accepted by expect_number() exactly, without limit on its length.
+/// Returns std::errc::result_out_of_range when the result overflows or a non-zero number rounds to zero.
+template<class T>
+std::errc decimal_to_float_exact(std::string_view number, T &value);
+
+extern template std::errc decimal_to_float_exact(std::string_view, float&);
+extern template std::errc decimal_to_float_exact(std::string_view, double&);
+extern template std::errc decimal_to_float_exact(std::string_view, long double&);
+
+/// Returns the correctly rounded double when mantissa and power of ten are both exact doubles, so a single
+/// multiplication or division rounds correctly. Otherwise returns nullopt.
+inline std::optional<double> exact_operands_to_double(const lexed_number &number)
+{
+#if FLT_EVAL_METHOD == 0 //no excess precision, which would round twice
+    if(number.mantissa > (std::uint64_t(1) << 53) || number.exponent < -22 || number.exponent > 22)
+        return std::nullopt;
+
+    double value = double(number.mantissa);
+    value = number.exponent < 0 ? value / exact_powers10[-number.exponent] : value * exact_powers10[number.exponent];
+    return number.negative ? -value : value;
+#else
+    return std::nullopt;
+#endif
+}
+
+/// Same as exact_operands_to_double() for long double in IEEE 754 format. Mantissas of up to 19 digits and powers of
+/// ten up to 10^27 are exact with the 64 bits of x87 extended precision.
+inline std::optional<long double> exact_operands_to_long_double(const lexed_number &number)
+{
+    if constexpr(std::numeric_limits<long double>::is_iec559 && std::numeric_limits<long double>::digits >= 64)
+    {
+        if(number.exponent < -27 || number.exponent > 27)
+            return std::nullopt;
+
+        long double value = (long double)number.mantissa;
+        value = number.exponent < 0 ? value / exact_powers10l[-number.exponent] : value * exact_powers10l[number.exponent];
+        return number.negative ? -value : value;
+    }
+    else
+    {
+        return std::nullopt;
+    }
+}
+
+/// Rejects conversions which overflowed or rounded a non-zero number to zero.
+template<class T>
+std::optional<T> in_range(const lexed_number &number, std::optional<T> value)
+{
+    if(value && (*value == 0 ? number.mantissa != 0 : (*value > std::numeric_limits<T>::max() || *value < -std::numeric_limits<T>::max())))
+        return std::nullopt;
+
+    return value;
+}
+
+} //end of detail
+
+
+/// Expects a number like expect_number() and decodes it into \p number at the same time.
+inline number_validation_result lex_number(std::string_view &source, lexed_number &number)
+{
+    number = lexed_number();
+    if(!source.empty() && source.front() == '-')
+    {
+        number.negative = true;
+        source.remove_prefix(1);
+    }
+
+    size_t zeros = detail::skip_zeros(source);
+    size_t significant = detail::lex_digits(source, number.mantissa);
+    if(zeros + significant == 0)
+        return detail::missing_digits(source);
+
+    if(!source.empty() && source.front() == '.')
+    {
+        source.remove_prefix(1);
+        number.integral = false;
+
+        size_t fraction_zeros = number.mantissa == 0 ? detail::skip_zeros(source) : 0; //zeros after the point are not significant as long as the mantissa is zero
+        size_t fraction = detail::lex_digits(source, number.mantissa);
+        if(fraction_zeros + fraction == 0)
+            return detail::missing_digits(source);
+
+        significant += fraction;
+        number.exponent = -std::int32_t(std::min(fraction_zeros + fraction, size_t(1000000000)));
+    }
+
+    number.exact = significant <= 19;
+
+    if(!source.empty() && (source.front() == 'e' || source.front() == 'E'))
+    {
+        source.remove_prefix(1);
+        if(source.empty())
+            return number_validation_result::eof;
+
+        bool negative_exponent = source.front() == '-';
+        if(negative_exponent)
+        {
+            source.remove_prefix(1);
+            number.integral = false;
+        }
+
+        std::int32_t exponent = 0;
+        size_t digits = 0;
+        for(; digits < source.size() && unsigned(source[digits] - '0') < 10; ++digits)
+        {
+            if(exponent < 100000000) //saturates, such numbers are out of range anyway
+                exponent = exponent * 10 + (source[digits] - '0');
+        }
+
+        source.remove_prefix(digits);
+        if(digits == 0)
+            return detail::missing_digits(source);
+
+        number.exponent += negative_exponent ? -exponent : exponent;
+    }
+
+    return number_validation_result::success;
+}
+
+
+/// Returns the number as signed integer, or nullopt if it is not integral or exceeds the range of std::int64_t.
+inline std::optional<std::int64_t> to_int64(const lexed_number &number)
+{
+    if(!number.exact || !number.integral || number.exponent > 19)
+        return std::nullopt;
+
+    std::uint64_t value = number.mantissa;
+    if(number.exponent > 0 && !safe_integer_power10(value, value, unsigned(number.exponent)))
+        return std::nullopt;
+
+    if(!number.negative)
+        return value <= std::uint64_t(INT64_MAX) ? std::optional<std::int64_t>(std::int64_t(value)) : std::nullopt;
+
+    return value <= std::uint64_t(INT64_MAX) + 1 ? std::optional<std::int64_t>(std::int64_t(0 - value)) : std::nullopt;
+}
+
+/// Returns the number as unsigned integer, or nullopt if it is negative, not integral or exceeds the range of std::uint64_t.
+inline std::optional<std::uint64_t> to_uint64(const lexed_number &number)
+{
+    if(!number.exact || !number.integral || number.negative || number.exponent > 19)
+        return std::nullopt;
+
+    std::uint64_t value = number.mantissa;
+    if(number.exponent > 0 && !safe_integer_power10(value, value, unsigned(number.exponent)))
+        return std::nullopt;
+
+    return value;
+}
+
+/// Returns the correctly rounded double, or nullopt if the mantissa is not exact, the rounding cannot be decided
+/// cheaply or the number is out of range.
+inline std::optional<double> to_double(const lexed_number &number)
+{
+    if(!number.exact)
+        return std::nullopt;
+
+    if(std::optional<double> value = detail::exact_operands_to_double(number))
+        return value;
+
+    return detail::in_range(number, detail::eisel_lemire<double>(number.mantissa, number.exponent, number.negative));
+}
+
+/// Same as to_double() for float.
+inline std::optional<float> to_float(const lexed_number &number)
+{
+    if(!number.exact)
+        return std::nullopt;
+
+    //rounding the correctly rounded double once more only differs from rounding the number directly when the double
+    //lies exactly halfway between two floats, as all these midpoints are doubles
+    if(std::optional<double> value = detail::exact_operands_to_double(number))
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &*value, sizeof(bits));
+        double magnitude = *value < 0 ? -*value : *value;
+        if((bits & ((std::uint64_t(1) << 29) - 1)) != std::uint64_t(1) << 28 && (magnitude == 0 || (magnitude >= FLT_MIN && magnitude <= FLT_MAX)))
+            return float(*value);
+    }
+
+    return detail::in_range(number, detail::eisel_lemire<float>(number.mantissa, number.exponent, number.negative));
+}
+
+
+/// Converts a number in the format of expect_number() to the nearest float, double or long double, rounding ties to
+/// even. Works like std::from_chars, but is independent of the locale and available on every toolchain. Returns
+/// std::errc::result_out_of_range when the result overflows or a non-zero number rounds to zero.
+template<class T>
+std::from_chars_result float_from_chars(const char *begin, const char *end, T &value)
+{
+    static_assert(std::is_floating_point_v<T>);
+
+    std::string_view source(begin, end - begin);
+    lexed_number number;
+    if(lex_number(source, number) != number_validation_result::success)
+        return { begin, std::errc::invalid_argument };
+
+    const char *stop = source.data();
+    std::optional<T> fast;
+    if constexpr(std::is_same_v<T, float>)
+        fast = to_float(number);
+    else if constexpr(std::is_same_v<T, double> || std::numeric_limits<long double>::digits == std::numeric_limits<double>::digits)
+        fast = to_double(number);
+    else if(number.exact)
+        fast = detail::exact_operands_to_long_double(number);
+
+    if(fast)
+    {
+        value = *fast;
+        return { stop, std::errc() };
+    }
+
+    return { stop, detail::decimal_to_float_exact(std::string_view(begin, stop - begin), value) };
+}
+
+}
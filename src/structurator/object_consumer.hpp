@@ -7,12 +7,14 @@
 
 #include <tuple>
 #include <array>
+#include <atomic>
 #include <variant>
 #include <utility>
 #include <algorithm>
 
 #include "meta.hpp"
 #include "doc_input.hpp"
+#include "key_table.hpp"
 #include "class_info.hpp"
 #include "ref_string.hpp"
 #include "doc_consumer.hpp"
@@ -27,6 +29,24 @@
 namespace stc
 {
 
+/// Counts how often the member that follows the previously read one in declaration order was predicted correctly
+/// for a key. Only counted when the library is configured with STRUCTURATOR_KEY_ORDER_STATS, which defines
+/// STC_KEY_ORDER_STATS for all its users, as counting costs an atomic increment per key.
+struct key_order_stats
+{
+    std::atomic<size_t> hits{ 0 }; ///< Keys resolved by a single comparison.
+    std::atomic<size_t> misses{ 0 }; ///< Keys which needed a look-up within the class' hash table.
+};
+
+/// Returns the statistics of key-order prediction of class \p T.
+template<class T>
+key_order_stats &get_key_order_stats()
+{
+    static key_order_stats stats;
+    return stats;
+}
+
+
 namespace detail
 {
 
@@ -52,11 +72,11 @@ auto make_discriminator_info(const MemberAlts &member_alts)
 /// Consumes the concrete alternative type.
 /// Given a tuple as specified at make_discriminator_info(), uses the alternative type which is dynamically indicated
 /// by the index (third entry) and reads content from the document into the given \p target.
-template<class T, class DiscrType, class... AltTypes, size_t... AltTypesIdx>
+template<class T, class DiscrType, class... AltTypes, size_t... AltTypesIdx, class Input>
 bool consume_discriminated(
     T &target,
     std::tuple<const member_alts<DiscrType, AltTypes...>&, std::index_sequence<AltTypesIdx...>, size_t> &discr_info,
-    doc_input::token_kind first, doc_input &input, const doc_context &context)
+    doc_input::token_kind first, Input &input, const doc_context &context)
 {
     using stc::consume;
     return (... || ( //iterate all alternatives
@@ -75,26 +95,22 @@ enum class alt_stat
 };
 
 
-/// Tries to match a key with values to determine the concrete alternative type.
-/// Given a tuple as specified at make_discriminator_info(), tries to match the specified key and reads the discriminative value
-/// from the document.
+/// Determines the concrete alternative type after the key of the discriminator was found.
+/// Given a tuple as specified at make_discriminator_info(), reads the discriminative value from the document.
 /// Then sets the third value of tuple to the index of the alternative type indicated by the discriminating value or
 /// directly reads content from the document, depending on the nesting mode.
 /// 
-template<class T, class MemberInfo, class DiscrType, class... AltTypes, size_t... AltTypesIdx>
-alt_stat try_consume_discriminator(
-    std::string_view key,
+template<class T, class MemberInfo, class DiscrType, class... AltTypes, size_t... AltTypesIdx, class Input>
+alt_stat consume_discriminator(
     T &object,
     const MemberInfo &minfo,
     bool &member_found,
     std::tuple<const member_alts<DiscrType, AltTypes...>&, std::index_sequence<AltTypesIdx...>, size_t> &discr_info,
-    doc_input::token_kind first, doc_input &input, const doc_context &context)
+    doc_input::token_kind first, Input &input, const doc_context &context)
 {
     const auto &member_alts = std::get<0>(discr_info);
-    if(key != member_alts.key)
-        return alt_stat::skipped;
-        
-    //reads std::string_view as ref_string, because former has no sensible consume() function
+
+    //reads std::string_view as ref_string, as the value is only compared and must not depend on the document's lifetime
     using parse_type = std::conditional_t<std::is_same_v<DiscrType, std::string_view>, ref_string, DiscrType>;
     auto value = consume(type_wrap<parse_type>(), first, input, context);
 
@@ -126,8 +142,8 @@ alt_stat try_consume_discriminator(
 }
 
 /// Overrload for non-tuples which were returned by make_discriminator_info().
-template<class T, class MemberInfo>
-constexpr alt_stat try_consume_discriminator(std::string_view key, T&, const MemberInfo&, bool, not_present_t, doc_input::token_kind, doc_input&, const doc_context&)
+template<class T, class MemberInfo, class Input>
+constexpr alt_stat consume_discriminator(T&, const MemberInfo&, bool, not_present_t, doc_input::token_kind, Input&, const doc_context&)
 {
     return alt_stat::skipped;
 }
@@ -143,15 +159,14 @@ enum class fill_stat
 
 
 /// Fills a member by consuming its type from the document.
-/// Tries matching the \p key with the name of the member within the specified \p object at index \p MemberIndex
-/// and consumes it.
-template<size_t MemberIndex = 0, class T, class DiscrInfo>
-fill_stat try_fill_member(
-    std::string_view key,
+/// The key of the current token must name the member within the specified \p object at index \p MemberIndex.
+/// With \p Reuse, the member is read into its current value with consume_existing(), so it keeps its capacity.
+template<size_t MemberIndex = 0, bool Reuse = false, class T, class DiscrInfo, class Input>
+fill_stat fill_member(
     T &object,
     bool &found_member,
     DiscrInfo &discr_info,
-    doc_input::token_kind first, doc_input &input, const doc_context &context)
+    doc_input::token_kind first, Input &input, const doc_context &context)
 {
     using stc::consume;
 
@@ -161,25 +176,13 @@ fill_stat try_fill_member(
     auto &member = object.*(minfo.member_ptr);
     using member_type = std::remove_reference_t<decltype(member)>;
 
-    static constexpr auto alias = get_member_attr<member_alias_tag>(minfo.options);
-    static constexpr auto shortn = get_member_attr<member_short_tag>(minfo.options);
-
-    bool matching_name = false;
-    if constexpr(alias != not_present)
-        matching_name = key == alias.alias_name;
-
-    if constexpr(shortn != not_present)
-        matching_name |= key == shortn.short_name;
-    else
-        matching_name |= key == minfo.name;
-
-    if(!matching_name)
-        return fill_stat::key_unknown;
-
     if(found_member) //member already encountered before
     {
         if constexpr(minfo.options.flags & unsigned(member_flag::first_of_multiple))
+        {
+            input.skip_value(first);
             return fill_stat::success;
+        }
 
         static constexpr unsigned multiple_flags = unsigned(member_flag::last_of_multiple) | unsigned(member_flag::multiple);
         if constexpr((minfo.options.flags & multiple_flags) == 0)
@@ -192,6 +195,7 @@ fill_stat try_fill_member(
             return fill_stat::success;
     }
 
+    bool first_time = !found_member;
     found_member = true;
 
     if constexpr(!std::is_same_v<decltype(discr_info), not_present_t&>) //try to consume the member for which alternatives are set
@@ -201,32 +205,192 @@ fill_stat try_fill_member(
     else if constexpr((minfo.options.flags & unsigned(member_flag::multiple)) != 0)
     {
         using type = typename std::remove_reference_t<decltype(member)>::value_type;
+        if(Reuse && first_time) //drop the values of the previous document
+            member.clear();
+
         member.emplace_back(consume(type_wrap<type>(), first, input, context));
         return fill_stat::success;
     }
+    else if constexpr(Reuse)
+    {
+        consume_existing(member, first, input, context);
+        return fill_stat::success;
+    }
     else
     {
+        (void)first_time;
         member = consume(type_wrap<member_type>(), first, input, context);
         return fill_stat::success;
     }
 }
 
-} //end of detail
 
+/// What a key of an object refers to.
+struct key_target
+{
+    size_t member = size_t(-1); ///< Index of the member named by the key, or -1.
+    size_t discriminator = size_t(-1); ///< Index of the member whose alternative type is chosen by the key's value, or -1.
+};
 
-/// Reads an entire object, depending on its defined class information.
-/// This cannot be put into the detail-namespace as MSVC would crash.
+/// Distinct keys of a class, at most three per member: its name or short name, its alias and the key of its discriminator.
+template<size_t MaxKeys>
+struct member_keys
+{
+    std::array<std::string_view, MaxKeys> keys = {};
+    std::array<key_target, MaxKeys> targets = {};
+    size_t count = 0;
+
+    /// Returns the target of the given key. The key must be present.
+    constexpr const key_target &find(std::string_view key) const
+    {
+        size_t i = 0;
+        while(keys[i] != key)
+            i++;
+
+        return targets[i];
+    }
+
+    /// Returns the target of the given key, which is added if not present yet.
+    constexpr key_target &target(std::string_view key)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            if(keys[i] == key)
+                return targets[i];
+        }
+
+        keys[count] = key;
+        return targets[count++];
+    }
+
+    /// Adds the keys of a member. Keys which are already taken by previous members are not changed, as those matched first before.
+    template<class MemberInfo>
+    constexpr void add(size_t index, const MemberInfo &minfo)
+    {
+        using alias_type = std::decay_t<decltype(get_member_attr<member_alias_tag>(minfo.options))>;
+        using short_type = std::decay_t<decltype(get_member_attr<member_short_tag>(minfo.options))>;
+        using alts_type = std::decay_t<decltype(get_member_attr<member_alts_tag>(minfo.options))>;
+
+        if constexpr(!std::is_same_v<alts_type, not_present_t>)
+        {
+            key_target &t = target(get_member_attr<member_alts_tag>(minfo.options).key);
+            t.discriminator = t.discriminator == size_t(-1) ? index : t.discriminator;
+        }
+
+        if constexpr(!std::is_same_v<alias_type, not_present_t>)
+        {
+            key_target &t = target(get_member_attr<member_alias_tag>(minfo.options).alias_name);
+            t.member = t.member == size_t(-1) ? index : t.member;
+        }
+
+        std::string_view name = minfo.name;
+        if constexpr(!std::is_same_v<short_type, not_present_t>)
+            name = get_member_attr<member_short_tag>(minfo.options).short_name;
+
+        key_target &t = target(name);
+        t.member = t.member == size_t(-1) ? index : t.member;
+    }
+};
+
+/// Collects the keys of all members of class \p T.
+template<class T, size_t... MembersIdx>
+constexpr auto collect_member_keys(std::index_sequence<MembersIdx...>)
+{
+    constexpr auto cinfo = get_class_info<T>();
+    member_keys<3 * sizeof...(MembersIdx)> collected;
+    (collected.add(MembersIdx, std::get<MembersIdx>(cinfo.members)), ...);
+    return collected;
+}
+
+/// Builds a perfect hash table that maps all keys of class \p T to their key_target.
 template<class T, size_t... MembersIdx>
-T consume_members(std::index_sequence<MembersIdx...>, doc_input::token_kind first, doc_input &input, const doc_context &context)
+constexpr auto make_member_key_table(std::index_sequence<MembersIdx...> seq)
+{
+    constexpr auto collected = collect_member_keys<T>(seq);
+
+    std::array<std::string_view, collected.count> keys = {};
+    std::array<key_target, collected.count> targets = {};
+    for(size_t i = 0; i < collected.count; ++i)
+    {
+        keys[i] = collected.keys[i];
+        targets[i] = collected.targets[i];
+    }
+
+    return make_key_table(keys, targets);
+}
+
+
+/// Name (or short name) of every member in declaration order. As documents mostly list keys in this order,
+/// the member following the previously read one is checked first with a single comparison.
+template<size_t MembersCount>
+struct member_order
+{
+    std::array<size_t, MembersCount> sizes = {};
+    std::array<key_words, MembersCount> words = {};
+    std::array<std::string_view, MembersCount> names = {};
+    std::array<key_target, MembersCount> targets = {};
+
+    /// Returns the target of the key if it is the name of the member at index \p predicted, otherwise nullptr.
+    const key_target *match(size_t predicted, std::string_view key, const key_words &key_words) const
+    {
+        if(predicted >= MembersCount || sizes[predicted] != key.size() || !(words[predicted] == key_words))
+            return nullptr;
+
+        if(key.size() > max_exact_key_size && names[predicted] != key)
+            return nullptr;
+
+        return &targets[predicted];
+    }
+};
+
+template<class T, size_t... MembersIdx>
+constexpr auto make_member_order(std::index_sequence<MembersIdx...> seq)
+{
+    constexpr auto cinfo = get_class_info<T>();
+    constexpr auto collected = collect_member_keys<T>(seq);
+
+    member_order<sizeof...(MembersIdx)> order;
+    auto add = [&](size_t index, const auto &minfo)
+    {
+        using short_type = std::decay_t<decltype(get_member_attr<member_short_tag>(minfo.options))>;
+
+        std::string_view name = minfo.name;
+        if constexpr(!std::is_same_v<short_type, not_present_t>)
+            name = get_member_attr<member_short_tag>(minfo.options).short_name;
+
+        order.sizes[index] = name.size();
+        order.words[index] = read_key_words(name);
+        order.names[index] = name;
+        order.targets[index] = collected.find(name); //the key might belong to a previous member
+    };
+
+    (add(MembersIdx, std::get<MembersIdx>(cinfo.members)), ...);
+    return order;
+}
+
+} //end of detail
+
+
+/// Reads the members of an entire object, depending on its defined class information.
+/// With \p Reuse, members are read into their current values and members which are not present in the document are
+/// reset to the values of a default constructed object. This cannot be put into the detail-namespace as MSVC would crash.
+template<bool Reuse, class T, size_t... MembersIdx, class Input>
+void consume_members_into(T &object, std::index_sequence<MembersIdx...>, doc_input::token_kind first, Input &input, const doc_context &context)
 {
     static constexpr auto cinfo = get_class_info<T>();
 
-    T object;
     std::array<bool, cinfo.members_count> found_members = {}; //indicates for which members keys were found, entries initially false
 
     static constexpr size_t add_keys_idx = //index of member which receives unknown keys, or -1 when none defined
         std::min({ (std::get<MembersIdx>(cinfo.members).options.flags & unsigned(member_flag::additional_keys) ? MembersIdx : size_t(-1))... });
 
+    static constexpr auto key_table = detail::make_member_key_table<T>(std::index_sequence<MembersIdx...>()); //resolves keys to members in O(1)
+    static constexpr auto member_order = detail::make_member_order<T>(std::index_sequence<MembersIdx...>());
+    size_t predicted = 0; //index of the member whose key likely comes next
+
+    if constexpr(Reuse && add_keys_idx != size_t(-1))
+        (object.*(std::get<add_keys_idx>(cinfo.members).member_ptr)).clear();
+
     auto discr_info = std::tuple( //holds some info per member with defined alternative types
         detail::make_discriminator_info(get_member_attr<member_alts_tag>(std::get<MembersIdx>(cinfo.members).options))..., 0 //add trailing element to avoid tuple copy constructor
     );
@@ -238,16 +402,32 @@ T consume_members(std::index_sequence<MembersIdx...>, doc_input::token_kind firs
         using detail::alt_stat;
 
         ref_string key = input.mapping_key();
+        detail::key_words key_words = detail::read_key_words(key);
+        const detail::key_target *target = member_order.match(predicted, key, key_words);
+
+#ifdef STC_KEY_ORDER_STATS
+        auto &stats = get_key_order_stats<T>();
+        (target != nullptr ? stats.hits : stats.misses).fetch_add(1, std::memory_order_relaxed);
+#endif
+
+        if(target == nullptr)
+            target = key_table.find(key, key_words);
 
-        //try matching a discriminator key: iterate members until try_consume_discriminator() returns something different than "skipped" (disjunction will short-circuit)
+        if(target != nullptr && target->member != size_t(-1))
+            predicted = target->member + 1;
+
+        //the key is a discriminator key: iterate members until the index matches (disjunction will short-circuit)
         alt_stat alt_status = alt_stat::skipped;
-        (... || (
-            (alt_status = detail::try_consume_discriminator(
-                key,
-                object,
-                std::get<MembersIdx>(cinfo.members),
-                found_members[MembersIdx], std::get<MembersIdx>(discr_info), token, input, context)) != alt_stat::skipped
-        ));
+        if(target != nullptr && target->discriminator != size_t(-1))
+        {
+            (... || (
+                MembersIdx == target->discriminator &&
+                (alt_status = detail::consume_discriminator(
+                    object,
+                    std::get<MembersIdx>(cinfo.members),
+                    found_members[MembersIdx], std::get<MembersIdx>(discr_info), token, input, context), true)
+            ));
+        }
 
         if(alt_status == alt_stat::success)
         {
@@ -263,16 +443,19 @@ T consume_members(std::index_sequence<MembersIdx...>, doc_input::token_kind firs
             throw doc_consume_exception();
         }
 
-        //try matching a member: iterate members until fill_member returns something different than "key_unknown" (disjunction will short-circuit)
+        //the key names a member: iterate members until the index matches (disjunction will short-circuit)
         fill_stat fill_status = fill_stat::key_unknown;
-        (... || (
-            (fill_status = detail::try_fill_member<MembersIdx>(
-                key,
-                object,
-                found_members[MembersIdx],
-                std::get<MembersIdx>(discr_info),
-                token, input, context)) != fill_stat::key_unknown
-        ));
+        if(target != nullptr && target->member != size_t(-1))
+        {
+            (... || (
+                MembersIdx == target->member &&
+                (fill_status = detail::fill_member<MembersIdx, Reuse>(
+                    object,
+                    found_members[MembersIdx],
+                    std::get<MembersIdx>(discr_info),
+                    token, input, context), true)
+            ));
+        }
 
         if(fill_status == fill_stat::key_unknown || fill_status == fill_stat::key_duplicate)
         {
@@ -282,10 +465,19 @@ T consume_members(std::index_sequence<MembersIdx...>, doc_input::token_kind firs
                 using key_type = typename std::remove_reference_t<decltype(map_member)>::key_type;
                 using value_type = typename std::remove_reference_t<decltype(map_member)>::mapped_type;
                 auto value = consume(type_wrap<value_type>(), token, input, context);
-                map_member.emplace(std::pair<key_type, value_type>(std::move(key), std::move(value)));
+                map_member.emplace(std::pair<key_type, value_type>(consume_key(type_wrap<key_type>(), std::move(key), input, context), std::move(value)));
             }
             else
             {
+                if constexpr((cinfo.flags & unsigned(class_flag::ignore_unknown_keys)) != 0)
+                {
+                    if(fill_status == fill_stat::key_unknown)
+                    {
+                        input.skip_value(token);
+                        continue;
+                    }
+                }
+
                 auto error = fill_status == fill_stat::key_unknown ? doc_error::kind::key_unknown : doc_error::kind::key_duplicate;
                 context.error_handler(doc_error{ input.location(doc_input::relative_loc::key), error });
                 throw doc_consume_exception();
@@ -307,13 +499,31 @@ T consume_members(std::index_sequence<MembersIdx...>, doc_input::token_kind firs
         throw doc_consume_exception();
     }
 
+    if constexpr(Reuse)
+    {
+        bool found_any_missing = (... || (!found_members[MembersIdx] && MembersIdx != add_keys_idx));
+        if(found_any_missing)
+        {
+            T defaults;
+            (..., (found_members[MembersIdx] || MembersIdx == add_keys_idx ||
+                (object.*(std::get<MembersIdx>(cinfo.members).member_ptr) = std::move(defaults.*(std::get<MembersIdx>(cinfo.members).member_ptr)), true)));
+        }
+    }
+}
+
+/// Reads an entire object, depending on its defined class information.
+template<class T, size_t... MembersIdx, class Input>
+T consume_members(std::index_sequence<MembersIdx...> seq, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    T object;
+    consume_members_into<false>(object, seq, first, input, context);
     return object;
 }
 
 
 /// Consumes a class for which class information is defined.
-template<class T>
-std::enable_if_t<get_class_info<T>() != not_present, T> consume(type_wrap<T>, doc_input::token_kind first, doc_input &input, const doc_context &context)
+template<class T, class Input>
+std::enable_if_t<get_class_info<T>() != not_present, T> consume(type_wrap<T>, doc_input::token_kind first, Input &input, const doc_context &context)
 {
     static_assert(std::is_default_constructible_v<T>, "Objects of this class must be default constructible.");
 
@@ -329,6 +539,24 @@ std::enable_if_t<get_class_info<T>() != not_present, T> consume(type_wrap<T>, do
     return consume_members<T>(std::make_index_sequence<cinfo.members_count>(), first, input, context);
 }
 
+/// Reads a class for which class information is defined into an existing object, see consume_members_into().
+template<class T, class Input>
+std::enable_if_t<get_class_info<T>() != not_present> consume_into(T &object, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    static_assert(std::is_default_constructible_v<T>, "Objects of this class must be default constructible.");
+
+    if(first != doc_input::token_kind::begin_mapping && !input.hint(doc_input::token_kind::begin_mapping))
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::type_mismatch });
+        throw doc_consume_exception();
+    }
+
+    constexpr auto cinfo = get_class_info<T>();
+    static_assert(cinfo.members_count > 0, "This class must have at least one member.");
+
+    consume_members_into<true>(object, std::make_index_sequence<cinfo.members_count>(), first, input, context);
+}
+
 }
 
 #pragma GCC diagnostic pop
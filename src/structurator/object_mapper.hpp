@@ -14,12 +14,15 @@ namespace stc
 
 /// Reads an object of some type from the specified input.
 /// A custom context object may be specified.
+/// consume() functions are instantiated for the static type of \p input, so passing a parser by its concrete type
+/// avoids virtual calls, see json::from_json().
 /// If the input is empty or an error occurred, std::nullopt is returned.
 /// User-defined classes need to be declared first using stc_declare_class().
-template<class T, class Context>
-std::optional<T> from_input_with_context(doc_input &input, Context &context)
+template<class T, class Context, class Input>
+std::optional<T> from_input_with_context(Input &input, Context &context)
 {
     static_assert(std::is_base_of_v<doc_context, Context>, "The specified context class must be derived from doc_context.");
+    static_assert(std::is_base_of_v<doc_input, Input>, "The specified input class must be derived from doc_input.");
     try
     {
         auto first = input.next_token();
@@ -37,11 +40,48 @@ std::optional<T> from_input_with_context(doc_input &input, Context &context)
 }
 
 /// Simple wrapper when not specifying a custom context.
-template<class T>
-std::optional<T> from_input(doc_input &input, doc_error_handler handler)
+template<class T, class Input>
+std::optional<T> from_input(Input &input, doc_error_handler handler)
 {
     doc_context context{ std::move(handler) };
     return from_input_with_context<T>(input, context);
 }
 
+/// Reads an object of some type from the specified input into \p target, which keeps the capacity of its strings,
+/// vectors and maps as far as consume_into() functions are defined for them, see consume_existing().
+/// Useful for reading many documents of the same shape without allocating each time.
+/// Returns false if the input is empty, which leaves \p target unchanged, or if an error occurred, which leaves it
+/// partially overwritten.
+template<class T, class Context, class Input>
+bool from_input_into_with_context(T &target, Input &input, Context &context)
+{
+    static_assert(std::is_base_of_v<doc_context, Context>, "The specified context class must be derived from doc_context.");
+    static_assert(std::is_base_of_v<doc_input, Input>, "The specified input class must be derived from doc_input.");
+    try
+    {
+        auto first = input.next_token();
+        if(first != doc_input::token_kind::eof)
+        {
+            consume_existing(target, first, input, context);
+            return true;
+        }
+    }
+    catch(const doc_input_exception&)
+    {
+    }
+    catch(const doc_consume_exception&)
+    {
+    }
+
+    return false;
+}
+
+/// Simple wrapper when not specifying a custom context.
+template<class T, class Input>
+bool from_input_into(T &target, Input &input, doc_error_handler handler)
+{
+    doc_context context{ std::move(handler) };
+    return from_input_into_with_context(target, input, context);
+}
+
 }
\ No newline at end of file
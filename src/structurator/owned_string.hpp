@@ -0,0 +1,122 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <cstring>
+#include <string_view>
+
+#include "ref_string.hpp"
+#include "doc_consumer.hpp"
+
+namespace stc
+{
+
+/// Read-only string which owns its characters, which are not null-terminated.
+/// When read from a document, a string that had to be unescaped into a buffer of its own is adopted from the
+/// ref_string by release(), so it is not copied again like it would be into a std::string. Strings referencing the
+/// document or an arena are copied once.
+class owned_string
+{
+public:
+    owned_string() = default;
+
+    /// Copies the given string.
+    explicit owned_string(std::string_view source) : length(source.size())
+    {
+        if(length == 0)
+            return;
+
+        chars.reset(new char[length]);
+        std::memcpy(chars.get(), source.data(), length);
+    }
+
+    owned_string(const owned_string &rhs) : owned_string(std::string_view(rhs))
+    {
+    }
+
+    owned_string(owned_string &&rhs) noexcept : chars(std::move(rhs.chars)), length(std::exchange(rhs.length, 0))
+    {
+    }
+
+    owned_string &operator=(const owned_string &rhs)
+    {
+        if(this != &rhs)
+            *this = owned_string(rhs);
+
+        return *this;
+    }
+
+    owned_string &operator=(owned_string &&rhs) noexcept
+    {
+        chars = std::move(rhs.chars);
+        length = std::exchange(rhs.length, 0);
+        return *this;
+    }
+
+    /// Takes over the buffer of an owning ref_string, otherwise copies it.
+    static owned_string adopt(ref_string &&source)
+    {
+        if(!source.is_allocated())
+            return owned_string(std::string_view(source));
+
+        owned_string str;
+        str.length = source.size();
+        str.chars = source.release();
+        return str;
+    }
+
+    /// Pointer to the first character, or nullptr when empty.
+    const char *data() const
+    {
+        return chars.get();
+    }
+
+    size_t size() const
+    {
+        return length;
+    }
+
+    bool empty() const
+    {
+        return length == 0;
+    }
+
+    bool operator==(const owned_string &rhs) const
+    {
+        return std::string_view(*this) == std::string_view(rhs);
+    }
+
+    bool operator!=(const owned_string &rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    bool operator<(const owned_string &rhs) const
+    {
+        return std::string_view(*this) < std::string_view(rhs);
+    }
+
+    operator std::string_view() const
+    {
+        return std::string_view(data(), size());
+    }
+
+private:
+    std::unique_ptr<char[]> chars;
+    size_t length = 0;
+};
+
+
+template<class Input>
+owned_string consume(type_wrap<owned_string>, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    if(first != doc_input::token_kind::string && !input.hint(doc_input::token_kind::string))
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::type_mismatch });
+        throw doc_consume_exception();
+    }
+
+    return owned_string::adopt(input.string());
+}
+
+}
\ No newline at end of file
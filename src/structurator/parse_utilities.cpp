@@ -1,8 +1,48 @@
 #include "parse_utilities.hpp"
 
+#include <algorithm>
+
+#include "simd_utilities.hpp"
+
 namespace stc
 {
 
+newline_index::newline_index(std::string_view source) : source(source)
+{
+    static constexpr size_t entry_size = blocks_per_entry * simd_block::size;
+    counts.reserve(source.size() / entry_size + 1);
+
+    size_t count = 0;
+    for(size_t pos = 0; pos + simd_block::size <= source.size(); pos += simd_block::size)
+    {
+        if(pos % entry_size == 0)
+            counts.push_back(count);
+
+        count += popcount(simd_block(source.data() + pos).equal('\n'));
+    }
+}
+
+size_t newline_index::count_before(size_t pos) const
+{
+    static constexpr size_t entry_size = blocks_per_entry * simd_block::size;
+    pos = std::min(pos, source.size());
+
+    //use the last entry before pos and count the remaining blocks and bytes
+    size_t count = 0;
+    size_t block_pos = 0;
+    if(!counts.empty())
+    {
+        size_t entry = std::min(pos / entry_size, counts.size() - 1);
+        count = counts[entry];
+        block_pos = entry * entry_size;
+    }
+
+    for(; block_pos + simd_block::size <= pos; block_pos += simd_block::size)
+        count += popcount(simd_block(source.data() + block_pos).equal('\n'));
+
+    return count + std::count(source.data() + block_pos, source.data() + pos, '\n');
+}
+
 number_validation_result expect_digits(std::string_view &source)
 {
     size_t count = 0;
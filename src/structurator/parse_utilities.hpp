@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 #include <climits>
 #include <string_view>
 
@@ -12,6 +14,19 @@
 namespace stc
 {
 
+/// Whether the specified character is skipped between tokens.
+inline bool is_whitespace(char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\f' || ch == '\r' || ch == '\n';
+}
+
+/// Line counter which discards all increments, for use when lines are not tracked.
+struct ignored_lines
+{
+    void operator++(int) {}
+    void operator+=(size_t) {}
+};
+
 /// Skips to the first non-whitespace and updates the current line
 template<class LineT>
 inline void skip_whitespaces(std::string_view &source, LineT &line)
@@ -19,7 +34,7 @@ inline void skip_whitespaces(std::string_view &source, LineT &line)
     while(!source.empty())
     {
         char ch = source.front();
-        if(ch != ' ' && ch != '\t' && ch != '\f' && ch != '\r' && ch != '\n')
+        if(!is_whitespace(ch))
             return;
 
         if(ch == '\n')
@@ -54,6 +69,49 @@ bool number_from_hex(const char *ptr, T &value)
     return true;
 }
 
+/// Computes the number represented by exactly four hexadecimal digits, handling all digits at once.
+/// Returns whether the characters were actual hexadecimal digits.
+inline bool number_from_hex4(const char *ptr, char16_t &value)
+{
+    std::uint32_t digits = std::uint32_t((unsigned char)ptr[0]) | std::uint32_t((unsigned char)ptr[1]) << 8 |
+        std::uint32_t((unsigned char)ptr[2]) << 16 | std::uint32_t((unsigned char)ptr[3]) << 24;
+
+    //per byte, the highest bit of each range check is set when the byte lies within [lo, hi]
+    auto in_range = [](std::uint32_t x, std::uint8_t lo, std::uint8_t hi)
+    {
+        return (x + 0x01010101u * (0x80 - lo)) & ~(x + 0x01010101u * (0x7F - hi)) & 0x80808080u;
+    };
+
+    std::uint32_t lower = digits | 0x20202020u; //maps A-F to a-f and keeps 0-9
+    std::uint32_t is_digit = in_range(digits, '0', '9');
+    std::uint32_t is_letter = in_range(lower, 'a', 'f');
+    if((digits & 0x80808080u) != 0 || (is_digit | is_letter) != 0x80808080u)
+        return false;
+
+    std::uint32_t nibbles = (lower & 0x0F0F0F0Fu) + (is_letter >> 7) * 9; //a-f have low nibbles 1-6
+    std::uint32_t pairs = (nibbles << 4 | nibbles >> 8) & 0x00FF00FFu; //first and third byte hold two digits each
+    value = char16_t((pairs & 0xFF) << 8 | pairs >> 16);
+    return true;
+}
+
+
+/// Counts new-lines before arbitrary positions within a document without scanning it from the beginning every time.
+/// Built once for the whole document, counting the new-lines of 64-byte blocks with SIMD.
+class newline_index
+{
+public:
+    explicit newline_index(std::string_view source);
+
+    /// Returns the number of new-lines before the byte at \p pos.
+    size_t count_before(size_t pos) const;
+
+private:
+    static constexpr size_t blocks_per_entry = 16;
+
+    std::string_view source;
+    std::vector<size_t> counts; ///< Number of new-lines before each group of blocks.
+};
+
 
 enum class number_validation_result
 {
@@ -7,6 +7,8 @@
 #include <cassert>
 #include <string_view>
 
+#include "arena.hpp"
+
 namespace stc
 {
 
@@ -15,65 +17,87 @@ namespace stc
 /// This is advantageous in situation where large strings need to be passed. In most cases, these can be
 /// passed without copying them, but sometimes they require, for instance in JSON, to be escaped first, so
 /// an un-escaped version has to be constructed.
+/// Owned strings of up to inline_capacity characters are stored within the object instead of on the heap. The bytes
+/// of pointer and length hold their characters then, and the most significant byte of the length tells them apart.
 class ref_string
 {
 public:
+    /// Maximum number of characters of owned strings which are stored within the object.
+    static constexpr size_t inline_capacity = sizeof(const char*) + sizeof(size_t) - 1;
+
     ref_string() = default;
 
     /// Constructs a non-owning ref_string.
-    ref_string(std::string_view source) noexcept : begin(source.data()), length(source.size())
+    ref_string(std::string_view source) noexcept
     {
-        assert(length < allocated_bit);
+        assert(source.size() < inline_bit);
+        set_reference(source.data(), source.size());
     }
 
     /// Move constructor. No copying allowed.
     ref_string(ref_string &&rhs) noexcept
     {
-        *this = std::move(rhs);
+        std::memcpy(bytes, rhs.bytes, sizeof(bytes));
+        std::memset(rhs.bytes, 0, sizeof(rhs.bytes));
     }
 
     ~ref_string()
     {
         if(is_allocated())
-            delete[] begin;
+            delete[] reference();
     }
 
     /// Move assignment.
     ref_string &operator=(ref_string &&rhs) noexcept
     {
+        if(this == &rhs)
+            return *this;
+
         if(is_allocated())
-            delete[] begin;
+            delete[] reference();
 
-        begin = std::exchange(rhs.begin, nullptr);
-        length = std::exchange(rhs.length, 0);
+        std::memcpy(bytes, rhs.bytes, sizeof(bytes));
+        std::memset(rhs.bytes, 0, sizeof(rhs.bytes));
         return *this;
     }
 
-    /// Returns whether the string is owned.
+    /// Returns whether the string is owned and allocated on the heap.
     bool is_allocated() const
     {
-        return length & allocated_bit;
+        return tag() & allocated_tag;
+    }
+
+    /// Returns whether the string is owned and stored within the object.
+    bool is_inline() const
+    {
+        return tag() & inline_tag;
+    }
+
+    /// Returns whether the string is owned, so it does not reference memory of someone else.
+    bool is_owned() const
+    {
+        return tag() & (allocated_tag | inline_tag);
     }
 
-    /// When owned, releases the allocated string as a std::unique_ptr.
+    /// When allocated, releases the string as a std::unique_ptr.
     std::unique_ptr<char[]> release()
     {
         assert(is_allocated());
-        const char *str = std::exchange(begin, nullptr);
-        length = 0;
+        const char *str = reference();
+        std::memset(bytes, 0, sizeof(bytes));
         return std::unique_ptr<char[]>(const_cast<char*>(str));
     }
 
     /// Pointer to first character or nullptr when empty.
     const char *data() const
     {
-        return begin;
+        return is_inline() ? bytes + inline_offset : reference();
     }
 
     /// Number of characters in the string.
     size_t size() const
     {
-        return length & ~allocated_bit;
+        return is_inline() ? size_t(tag() & ~inline_tag) : stored_length() & ~allocated_bit;
     }
 
     bool operator==(const ref_string &rhs) const
@@ -91,25 +115,109 @@ public:
         return std::string_view(data(), size());
     }
 
-    /// Copies the given string into a new owning ref_string.
+    /// Copies the given string into a new owning ref_string, which is stored inline if short enough.
     static ref_string make_copy(std::string_view source)
     {
-        assert(source.size() < allocated_bit);
+        return make(source.size(), [&](char *out)
+        {
+            std::memcpy(out, source.data(), source.size());
+            return out + source.size();
+        });
+    }
 
-        char *ptr = new char[source.size()];
+    /// Copies the given string into memory from \p storage. The result does not own the copy, which stays valid
+    /// until the arena is reset.
+    static ref_string make_copy(std::string_view source, arena &storage)
+    {
+        char *ptr = storage.allocate_chars(source.size());
         std::memcpy(ptr, source.data(), source.size());
+        return ref_string(std::string_view(ptr, source.size()));
+    }
 
+    /// Constructs an owning ref_string of at most \p max_size characters, which \p write writes to the given buffer
+    /// and returns the end of. The buffer lies within the object when \p max_size is at most inline_capacity and
+    /// is allocated otherwise, so writers need not know where the result is stored.
+    template<class Fn>
+    static ref_string make(size_t max_size, Fn &&write)
+    {
         ref_string str;
-        str.begin = ptr;
-        str.length = source.size() | allocated_bit;
+        if(max_size == 0)
+            return str;
+
+        if(max_size <= inline_capacity)
+        {
+            char *out = str.bytes + inline_offset;
+            size_t size = write(out) - out;
+            assert(size <= max_size);
+            str.bytes[tag_offset] = char(inline_tag | size);
+            return str;
+        }
+
+        auto buffer = std::make_unique<char[]>(max_size);
+        size_t size = write(buffer.get()) - buffer.get();
+        assert(size <= max_size);
+        return adopt(std::move(buffer), size);
+    }
+
+    /// Takes ownership of an allocated string of which the first \p size characters are used.
+    /// Complements release().
+    static ref_string adopt(std::unique_ptr<char[]> ptr, size_t size)
+    {
+        assert(size < inline_bit);
+
+        ref_string str;
+        str.set_reference(ptr.release(), size | allocated_bit);
         return str;
     }
 
 private:
-    const char *begin = nullptr;
-    size_t length = 0; ///< Highest bit indicates whether the string is referenced or allocated.
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    static constexpr size_t length_offset = 0; ///< The most significant byte of the length comes first.
+    static constexpr size_t pointer_offset = sizeof(size_t);
+    static constexpr size_t tag_offset = 0;
+    static constexpr size_t inline_offset = 1;
+#else
+    static constexpr size_t pointer_offset = 0;
+    static constexpr size_t length_offset = sizeof(const char*); ///< The most significant byte of the length comes last.
+    static constexpr size_t tag_offset = sizeof(const char*) + sizeof(size_t) - 1;
+    static constexpr size_t inline_offset = 0;
+#endif
 
     static constexpr size_t allocated_bit = size_t(1) << (sizeof(size_t) * CHAR_BIT - 1);
+    static constexpr size_t inline_bit = allocated_bit >> 1; ///< Never set in lengths, as it marks inline strings.
+    static constexpr unsigned char allocated_tag = 0x80; ///< allocated_bit within the most significant byte.
+    static constexpr unsigned char inline_tag = 0x40; ///< inline_bit within the most significant byte, below it the inline length.
+    static_assert(inline_capacity < inline_tag);
+
+    /// Either a pointer and a length, whose highest bit indicates whether the string is referenced or allocated, or
+    /// the characters of an inline string and its length in the byte at tag_offset. Accessed by std::memcpy, which
+    /// compiles to plain loads and stores.
+    alignas(const char*) char bytes[sizeof(const char*) + sizeof(size_t)] = {};
+
+    unsigned char tag() const
+    {
+        return static_cast<unsigned char>(bytes[tag_offset]);
+    }
+
+    const char *reference() const
+    {
+        const char *ptr;
+        std::memcpy(&ptr, bytes + pointer_offset, sizeof(ptr));
+        return ptr;
+    }
+
+    size_t stored_length() const
+    {
+        size_t length;
+        std::memcpy(&length, bytes + length_offset, sizeof(length));
+        return length;
+    }
+
+    void set_reference(const char *ptr, size_t length)
+    {
+        std::memcpy(bytes + pointer_offset, &ptr, sizeof(ptr));
+        std::memcpy(bytes + length_offset, &length, sizeof(length));
+    }
 };
 
 
@@ -0,0 +1,181 @@
+#pragma once
+
+///
+/// \file
+/// \brief Portable helpers for classifying blocks of bytes using SSE2/AVX2 where available.
+///
+/// Every comparison yields a bit mask in which bit i corresponds to byte i of the block.
+/// Without SIMD support, the same masks are computed one byte at a time.
+///
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+    #define STC_SIMD_AVX2
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define STC_SIMD_SSE2
+    #include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+namespace stc
+{
+
+/// Returns the index of the lowest set bit. The value must not be zero.
+inline unsigned trailing_zeros(std::uint64_t value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx;
+    _BitScanForward64(&idx, value);
+    return unsigned(idx);
+#else
+    return unsigned(__builtin_ctzll(value));
+#endif
+}
+
+/// Returns the number of zero bits above the highest set bit. The value must not be zero.
+inline unsigned leading_zeros(std::uint64_t value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx;
+    _BitScanReverse64(&idx, value);
+    return 63 - unsigned(idx);
+#else
+    return unsigned(__builtin_clzll(value));
+#endif
+}
+
+/// Returns the number of set bits.
+inline unsigned popcount(std::uint64_t value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return unsigned(__popcnt64(value));
+#else
+    return unsigned(__builtin_popcountll(value));
+#endif
+}
+
+/// Returns a mask in which each bit is the exclusive-or of itself and all lower bits of \p value.
+/// Applied to quote positions, this marks every byte between an opening and a closing quote.
+inline std::uint64_t prefix_xor(std::uint64_t value)
+{
+    value ^= value << 1;
+    value ^= value << 2;
+    value ^= value << 4;
+    value ^= value << 8;
+    value ^= value << 16;
+    value ^= value << 32;
+    return value;
+}
+
+
+/// Returns a mask of all bytes which are escaped by a preceding backslash, considering runs of backslashes.
+/// \p prev_escaped carries whether the first byte of the next block is escaped.
+inline std::uint64_t find_escaped(std::uint64_t backslash, std::uint64_t &prev_escaped)
+{
+    static constexpr std::uint64_t even_bits = 0x5555555555555555ULL;
+
+    backslash &= ~prev_escaped; //an escaped backslash does not escape anything
+    std::uint64_t follows_escape = backslash << 1 | prev_escaped;
+
+    //runs of backslashes starting on odd bits escape the byte after them when their length is odd,
+    //adding flips the run to a carry right after its end
+    std::uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+    std::uint64_t sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+    prev_escaped = sequences_starting_on_even_bits < backslash; //overflow
+
+    std::uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+    return (even_bits ^ invert_mask) & follows_escape;
+}
+
+
+/// 64 consecutive bytes which are compared at once.
+class simd_block
+{
+public:
+    static constexpr size_t size = 64;
+
+    /// Loads exactly size bytes from \p ptr.
+    explicit simd_block(const char *ptr)
+    {
+#if defined(STC_SIMD_AVX2)
+        chunks[0] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        chunks[1] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + 32));
+#elif defined(STC_SIMD_SSE2)
+        for(int i = 0; i < 4; ++i)
+            chunks[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + 16 * i));
+#else
+        std::memcpy(bytes, ptr, size);
+#endif
+    }
+
+    /// Bytes which are equal to \p c.
+    std::uint64_t equal(char c) const
+    {
+#if defined(STC_SIMD_AVX2)
+        __m256i needle = _mm256_set1_epi8(c);
+        return combine(_mm256_cmpeq_epi8(chunks[0], needle), _mm256_cmpeq_epi8(chunks[1], needle));
+#elif defined(STC_SIMD_SSE2)
+        __m128i needle = _mm_set1_epi8(c);
+        return combine(
+            _mm_cmpeq_epi8(chunks[0], needle), _mm_cmpeq_epi8(chunks[1], needle),
+            _mm_cmpeq_epi8(chunks[2], needle), _mm_cmpeq_epi8(chunks[3], needle));
+#else
+        std::uint64_t mask = 0;
+        for(size_t i = 0; i < size; ++i)
+            mask |= std::uint64_t(bytes[i] == c) << i;
+        return mask;
+#endif
+    }
+
+    /// Bytes which are less than \p c when interpreted as unsigned. \p c must not be zero.
+    std::uint64_t less(unsigned char c) const
+    {
+#if defined(STC_SIMD_AVX2)
+        __m256i limit = _mm256_set1_epi8(char(c - 1));
+        return combine(
+            _mm256_cmpeq_epi8(_mm256_max_epu8(chunks[0], limit), limit),
+            _mm256_cmpeq_epi8(_mm256_max_epu8(chunks[1], limit), limit));
+#elif defined(STC_SIMD_SSE2)
+        __m128i limit = _mm_set1_epi8(char(c - 1));
+        return combine(
+            _mm_cmpeq_epi8(_mm_max_epu8(chunks[0], limit), limit), _mm_cmpeq_epi8(_mm_max_epu8(chunks[1], limit), limit),
+            _mm_cmpeq_epi8(_mm_max_epu8(chunks[2], limit), limit), _mm_cmpeq_epi8(_mm_max_epu8(chunks[3], limit), limit));
+#else
+        std::uint64_t mask = 0;
+        for(size_t i = 0; i < size; ++i)
+            mask |= std::uint64_t((unsigned char)bytes[i] < c) << i;
+        return mask;
+#endif
+    }
+
+private:
+#if defined(STC_SIMD_AVX2)
+    __m256i chunks[2];
+
+    static std::uint64_t combine(__m256i lo, __m256i hi)
+    {
+        return std::uint64_t(std::uint32_t(_mm256_movemask_epi8(lo))) | std::uint64_t(std::uint32_t(_mm256_movemask_epi8(hi))) << 32;
+    }
+#elif defined(STC_SIMD_SSE2)
+    __m128i chunks[4];
+
+    static std::uint64_t combine(__m128i c0, __m128i c1, __m128i c2, __m128i c3)
+    {
+        return std::uint64_t(std::uint16_t(_mm_movemask_epi8(c0))) |
+            std::uint64_t(std::uint16_t(_mm_movemask_epi8(c1))) << 16 |
+            std::uint64_t(std::uint16_t(_mm_movemask_epi8(c2))) << 32 |
+            std::uint64_t(std::uint16_t(_mm_movemask_epi8(c3))) << 48;
+    }
+#else
+    char bytes[size];
+#endif
+};
+
+}
\ No newline at end of file
@@ -48,8 +48,8 @@ private:
 };
 
 
-template<class T, size_t MinSize, size_t MaxSize>
-size_bounded<T, MinSize, MaxSize> consume(type_wrap<size_bounded<T, MinSize, MaxSize>>, doc_input::token_kind first, doc_input &input, const doc_context &context)
+template<class T, size_t MinSize, size_t MaxSize, class Input>
+size_bounded<T, MinSize, MaxSize> consume(type_wrap<size_bounded<T, MinSize, MaxSize>>, doc_input::token_kind first, Input &input, const doc_context &context)
 {
     T t = consume(type_wrap<T>(), first, input, context);
     if(t.size() < MinSize || t.size() > MaxSize)
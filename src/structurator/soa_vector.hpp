@@ -0,0 +1,404 @@
+#pragma once
+
+///
+/// \file
+/// \brief Defines soa_vector, which stores arrays of declared classes as one contiguous column per member.
+///
+/// Scanning a single member over many rows of a std::vector<T> loads every other member into the cache as well.
+/// soa_vector<T> keeps a std::vector per member instead and its consumer appends the values of each row directly to
+/// these columns while parsing. Rows are accessed through proxies.
+///
+
+#include <tuple>
+#include <array>
+#include <vector>
+#include <cassert>
+#include <utility>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+
+#include "doc_input.hpp"
+#include "class_info.hpp"
+#include "doc_consumer.hpp"
+#include "object_consumer.hpp"
+
+namespace stc
+{
+
+namespace detail
+{
+
+template<class T, class Seq>
+struct soa_columns;
+
+template<class T, size_t... MembersIdx>
+struct soa_columns<T, std::index_sequence<MembersIdx...>>
+{
+    using members_type = std::remove_const_t<decltype(get_class_info<T>().members)>;
+    using type = std::tuple<std::vector<typename std::tuple_element_t<MembersIdx, members_type>::member_type>...>;
+};
+
+} //end of detail
+
+
+/// Sequence of objects of a declared class T, whose members are stored in separate std::vectors in declaration
+/// order. Members which are not declared are not stored. Rows are accessed through proxies, which refer to the
+/// members of one row and convert to T.
+template<class T>
+class soa_vector
+{
+    static constexpr auto cinfo = get_class_info<T>();
+    using indices = std::make_index_sequence<cinfo.members_count>;
+
+public:
+    using columns_type = typename detail::soa_columns<T, indices>::type;
+
+    /// Type of the member at \p MemberIndex in declaration order.
+    template<size_t MemberIndex>
+    using member_type = typename std::tuple_element_t<MemberIndex, columns_type>::value_type;
+
+    /// Refers to the members of one row.
+    template<bool Const>
+    class basic_row
+    {
+    public:
+        using owner_type = std::conditional_t<Const, const soa_vector, soa_vector>;
+
+        basic_row(owner_type &owner, size_t index) : owner(&owner), index(index) {}
+
+        /// Returns the member at \p MemberIndex in declaration order.
+        template<size_t MemberIndex>
+        decltype(auto) get() const
+        {
+            return owner->template column<MemberIndex>()[index];
+        }
+
+        /// Returns the given member, e.g. row[&T::member].
+        template<class M>
+        decltype(auto) operator[](M T::*member) const
+        {
+            return owner->column(member)[index];
+        }
+
+        /// Copies the row into an object.
+        operator T() const
+        {
+            T object;
+            copy_to(object, indices());
+            return object;
+        }
+
+        /// Overwrites the row with the members of \p object.
+        template<bool C = Const, class = std::enable_if_t<!C>>
+        const basic_row &operator=(const T &object) const
+        {
+            copy_from(object, indices());
+            return *this;
+        }
+
+    private:
+        owner_type *owner;
+        size_t index;
+
+        template<size_t... MembersIdx>
+        void copy_to(T &object, std::index_sequence<MembersIdx...>) const
+        {
+            (..., (object.*(std::get<MembersIdx>(cinfo.members).member_ptr) = this->template get<MembersIdx>()));
+        }
+
+        template<size_t... MembersIdx>
+        void copy_from(const T &object, std::index_sequence<MembersIdx...>) const
+        {
+            (..., (this->template get<MembersIdx>() = object.*(std::get<MembersIdx>(cinfo.members).member_ptr)));
+        }
+    };
+
+    using row = basic_row<false>;
+    using const_row = basic_row<true>;
+
+    /// Iterates the rows as proxies.
+    template<bool Const>
+    class basic_iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = basic_row<Const>;
+
+        basic_iterator(typename basic_row<Const>::owner_type &owner, size_t index) : owner(&owner), index(index) {}
+
+        reference operator*() const
+        {
+            return reference(*owner, index);
+        }
+
+        basic_iterator &operator++()
+        {
+            index++;
+            return *this;
+        }
+
+        bool operator==(const basic_iterator &rhs) const
+        {
+            return index == rhs.index;
+        }
+
+        bool operator!=(const basic_iterator &rhs) const
+        {
+            return index != rhs.index;
+        }
+
+    private:
+        typename basic_row<Const>::owner_type *owner;
+        size_t index;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    size_t size() const
+    {
+        return std::get<0>(columns).size();
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    row operator[](size_t index)
+    {
+        assert(index < size());
+        return row(*this, index);
+    }
+
+    const_row operator[](size_t index) const
+    {
+        assert(index < size());
+        return const_row(*this, index);
+    }
+
+    iterator begin() { return iterator(*this, 0); }
+    iterator end() { return iterator(*this, size()); }
+    const_iterator begin() const { return const_iterator(*this, 0); }
+    const_iterator end() const { return const_iterator(*this, size()); }
+
+    /// Returns the column of the member at \p MemberIndex in declaration order.
+    template<size_t MemberIndex>
+    std::vector<member_type<MemberIndex>> &column()
+    {
+        return std::get<MemberIndex>(columns);
+    }
+
+    template<size_t MemberIndex>
+    const std::vector<member_type<MemberIndex>> &column() const
+    {
+        return std::get<MemberIndex>(columns);
+    }
+
+    /// Returns the column of the given member, e.g. column(&T::member), which must be declared.
+    template<class M>
+    std::vector<M> &column(M T::*member)
+    {
+        std::vector<M> *found = find_column(member, indices());
+        assert(found != nullptr);
+        return *found;
+    }
+
+    template<class M>
+    const std::vector<M> &column(M T::*member) const
+    {
+        return const_cast<soa_vector*>(this)->column(member);
+    }
+
+    /// Appends the members of \p object.
+    void push_back(T object)
+    {
+        push_members(object, indices());
+    }
+
+    void reserve(size_t count)
+    {
+        std::apply([count](auto&... c) { (c.reserve(count), ...); }, columns);
+    }
+
+    void clear()
+    {
+        std::apply([](auto&... c) { (c.clear(), ...); }, columns);
+    }
+
+private:
+    columns_type columns;
+
+    template<class M, size_t... MembersIdx>
+    std::vector<M> *find_column(M T::*member, std::index_sequence<MembersIdx...>)
+    {
+        std::vector<M> *found = nullptr;
+        (..., [&]
+        {
+            if constexpr(std::is_same_v<member_type<MembersIdx>, M>)
+            {
+                if(std::get<MembersIdx>(cinfo.members).member_ptr == member)
+                    found = &std::get<MembersIdx>(columns);
+            }
+        }());
+
+        return found;
+    }
+
+    template<size_t... MembersIdx>
+    void push_members(T &object, std::index_sequence<MembersIdx...>)
+    {
+        (..., std::get<MembersIdx>(columns).push_back(std::move(object.*(std::get<MembersIdx>(cinfo.members).member_ptr))));
+    }
+};
+
+
+namespace detail
+{
+
+/// Appends the value of the current key to the column of the member at \p MemberIndex, unless the member was found
+/// before within the row.
+template<size_t MemberIndex, class T, class Input>
+void fill_soa_column(soa_vector<T> &rows, size_t row, bool &found_member, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    static constexpr auto cinfo = get_class_info<T>();
+    static constexpr const auto &minfo = std::get<MemberIndex>(cinfo.members);
+    using member_type = typename soa_vector<T>::template member_type<MemberIndex>;
+
+    auto &column = rows.template column<MemberIndex>();
+    if(found_member)
+    {
+        if constexpr(minfo.options.flags & unsigned(member_flag::first_of_multiple))
+        {
+            input.skip_value(first);
+            return;
+        }
+        else if constexpr(minfo.options.flags & unsigned(member_flag::last_of_multiple))
+        {
+            consume_existing(column[row], first, input, context);
+            return;
+        }
+        else
+        {
+            context.error_handler(doc_error{ input.location(doc_input::relative_loc::key), doc_error::kind::key_duplicate });
+            throw doc_consume_exception();
+        }
+    }
+
+    if constexpr((minfo.options.flags & unsigned(member_flag::maybe_default)) != 0)
+    {
+        if(first == doc_input::token_kind::null) //null treated as if member was not present
+            return;
+    }
+
+    column.emplace_back(consume(type_wrap<member_type>(), first, input, context));
+    found_member = true;
+}
+
+/// Reads one object and appends its members to the columns.
+template<class T, size_t... MembersIdx, class Input>
+void consume_soa_row(soa_vector<T> &rows, std::optional<T> &defaults, std::index_sequence<MembersIdx...>,
+    doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    static constexpr auto cinfo = get_class_info<T>();
+    static constexpr auto key_table = make_member_key_table<T>(std::index_sequence<MembersIdx...>());
+    static constexpr auto member_order = make_member_order<T>(std::index_sequence<MembersIdx...>());
+
+    if(first != doc_input::token_kind::begin_mapping && !input.hint(doc_input::token_kind::begin_mapping))
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::type_mismatch });
+        throw doc_consume_exception();
+    }
+
+    size_t row = rows.size();
+    std::array<bool, cinfo.members_count> found_members = {};
+    size_t predicted = 0;
+
+    doc_input::token_kind token;
+    while((token = input.next_token()) != doc_input::token_kind::end_mapping)
+    {
+        ref_string key = input.mapping_key();
+        key_words words = read_key_words(key);
+        const key_target *target = member_order.match(predicted, key, words);
+        if(target == nullptr)
+            target = key_table.find(key, words);
+
+        if(target == nullptr || target->member == size_t(-1))
+        {
+            if constexpr((cinfo.flags & unsigned(class_flag::ignore_unknown_keys)) != 0)
+            {
+                input.skip_value(token);
+                continue;
+            }
+
+            context.error_handler(doc_error{ input.location(doc_input::relative_loc::key), doc_error::kind::key_unknown });
+            throw doc_consume_exception();
+        }
+
+        predicted = target->member + 1;
+        (... || (MembersIdx == target->member && (fill_soa_column<MembersIdx>(rows, row, found_members[MembersIdx], token, input, context), true)));
+    }
+
+    //members which are absent take their default values, others are required
+    (..., [&]
+    {
+        static constexpr const auto &minfo = std::get<MembersIdx>(cinfo.members);
+        if(found_members[MembersIdx])
+            return;
+
+        if constexpr((minfo.options.flags & unsigned(member_flag::maybe_default)) != 0)
+        {
+            if(!defaults)
+                defaults.emplace();
+
+            rows.template column<MembersIdx>().push_back((*defaults).*(minfo.member_ptr));
+        }
+        else
+        {
+            context.error_handler(doc_error{ input.location(), doc_error::kind::key_missing });
+            throw doc_consume_exception();
+        }
+    }());
+}
+
+} //end of detail
+
+
+/// Reads an array of objects of a declared class into columns. Classes with member_alts or members flagged with
+/// additional_keys or multiple are not supported.
+template<class T, class Input>
+soa_vector<T> consume(type_wrap<soa_vector<T>>, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    static constexpr auto cinfo = get_class_info<T>();
+    using indices = std::make_index_sequence<cinfo.members_count>;
+
+    static_assert(std::apply([](const auto&... minfo)
+    {
+        constexpr unsigned unsupported = unsigned(member_flag::additional_keys) | unsigned(member_flag::multiple);
+        return (... && ((minfo.options.flags & unsupported) == 0 &&
+            std::is_same_v<std::decay_t<decltype(get_member_attr<member_alts_tag>(minfo.options))>, not_present_t>));
+    }, cinfo.members), "soa_vector does not support member_alts and members flagged with additional_keys or multiple.");
+
+    if(first != doc_input::token_kind::begin_array && !input.hint(doc_input::token_kind::begin_array))
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::type_mismatch });
+        throw doc_consume_exception();
+    }
+
+    soa_vector<T> rows;
+    if(std::optional<size_t> count = input.element_count_hint())
+        rows.reserve(*count);
+
+    std::optional<T> defaults; //constructed when a member is absent for the first time
+    doc_input::token_kind token;
+    while((token = input.next_token()) != doc_input::token_kind::end_array)
+        detail::consume_soa_row(rows, defaults, indices(), token, input, context);
+
+    return rows;
+}
+
+}
\ No newline at end of file
@@ -11,6 +11,8 @@
 #include <vector>
 #include <optional>
 #include <algorithm>
+#include <type_traits>
+#include <unordered_map>
 
 #include "doc_input.hpp"
 #include "doc_consumer.hpp"
@@ -18,7 +20,8 @@
 namespace stc
 {
 
-inline std::string consume(type_wrap<std::string>, doc_input::token_kind first, doc_input &input, const doc_context &context)
+template<class Input>
+std::string consume(type_wrap<std::string>, doc_input::token_kind first, Input &input, const doc_context &context)
 {
     if(first != doc_input::token_kind::string && !input.hint(doc_input::token_kind::string))
     {
@@ -29,9 +32,23 @@ inline std::string consume(type_wrap<std::string>, doc_input::token_kind first,
     return std::string(input.string());
 }
 
+/// Assigns the string, keeping the capacity of \p target.
+template<class Input>
+void consume_into(std::string &target, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    if(first != doc_input::token_kind::string && !input.hint(doc_input::token_kind::string))
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::type_mismatch });
+        throw doc_consume_exception();
+    }
+
+    ref_string string = input.string();
+    target.assign(string.data(), string.size());
+}
+
 
-template<class T>
-std::optional<T> consume(type_wrap<std::optional<T>>, doc_input::token_kind first, doc_input &input, const doc_context &context)
+template<class T, class Input>
+std::optional<T> consume(type_wrap<std::optional<T>>, doc_input::token_kind first, Input &input, const doc_context &context)
 {
     if(first == doc_input::token_kind::eof || first == doc_input::token_kind::null)
         return std::nullopt;
@@ -39,16 +56,54 @@ std::optional<T> consume(type_wrap<std::optional<T>>, doc_input::token_kind firs
     return consume(type_wrap<T>(), first, input, context);
 }
 
+template<class T, class Input>
+void consume_into(std::optional<T> &target, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    if(first == doc_input::token_kind::eof || first == doc_input::token_kind::null)
+        target.reset();
+    else if(target)
+        consume_existing(*target, first, input, context);
+    else
+        target = consume(type_wrap<T>(), first, input, context);
+}
+
 
-template<class T>
-std::unique_ptr<T> consume(type_wrap<std::unique_ptr<T>>, doc_input::token_kind first, doc_input &input, const doc_context &context)
+template<class T, class Input>
+std::unique_ptr<T> consume(type_wrap<std::unique_ptr<T>>, doc_input::token_kind first, Input &input, const doc_context &context)
 {
     return std::make_unique<T>(consume(type_wrap<T>(), first, input, context));
 }
 
+template<class T, class Input>
+void consume_into(std::unique_ptr<T> &target, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    if(target)
+        consume_existing(*target, first, input, context);
+    else
+        target = std::make_unique<T>(consume(type_wrap<T>(), first, input, context));
+}
+
+
+namespace detail
+{
+
+/// Reads the first element of an array after its begin token. Arrays of numbers which inputs decode themselves read
+/// the leading run of numbers through doc_input::read_number_array(), which calls \p on_number for each of them.
+/// long double is always converted from the raw number, which outweighs the cheaper loop.
+template<class T, class Input, class Fn>
+doc_input::token_kind read_number_elements(Input &input, Fn &&on_number)
+{
+    if constexpr((std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>) || std::is_same_v<T, float> || std::is_same_v<T, double>)
+        return input.read_number_array(on_number);
+    else
+        return input.next_token();
+}
+
+} //end of detail
+
 
-template<class T, size_t N>
-std::array<T, N> consume(type_wrap<std::array<T, N>>, doc_input::token_kind first, doc_input &input, const doc_context &context)
+template<class T, size_t N, class Input>
+std::array<T, N> consume(type_wrap<std::array<T, N>>, doc_input::token_kind first, Input &input, const doc_context &context)
 {
     if(first != doc_input::token_kind::begin_array && !input.hint(doc_input::token_kind::begin_array))
     {
@@ -58,8 +113,13 @@ std::array<T, N> consume(type_wrap<std::array<T, N>>, doc_input::token_kind firs
 
     std::array<T, N> array;
     size_t count = 0;
-    doc_input::token_kind token;
-    while((token = input.next_token()) != doc_input::token_kind::end_array)
+    doc_input::token_kind token = detail::read_number_elements<T>(input, [&]
+    {
+        array[std::min(count, N - 1)] = consume(type_wrap<T>(), doc_input::token_kind::number, input, context);
+        count++;
+    });
+
+    for(; token != doc_input::token_kind::end_array; token = input.next_token())
     {
         array[std::min(count, N - 1)] = consume(type_wrap<T>(), token, input, context);
         count++;
@@ -74,9 +134,38 @@ std::array<T, N> consume(type_wrap<std::array<T, N>>, doc_input::token_kind firs
     return array;
 }
 
+template<class T, size_t N, class Input>
+void consume_into(std::array<T, N> &array, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    if(first != doc_input::token_kind::begin_array && !input.hint(doc_input::token_kind::begin_array))
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::type_mismatch });
+        throw doc_consume_exception();
+    }
+
+    size_t count = 0;
+    doc_input::token_kind token = detail::read_number_elements<T>(input, [&]
+    {
+        consume_existing(array[std::min(count, N - 1)], doc_input::token_kind::number, input, context);
+        count++;
+    });
 
-template<class T>
-std::vector<T> consume(type_wrap<std::vector<T>>, doc_input::token_kind first, doc_input &input, const doc_context &context)
+    for(; token != doc_input::token_kind::end_array; token = input.next_token())
+    {
+        consume_existing(array[std::min(count, N - 1)], token, input, context);
+        count++;
+    }
+
+    if(count != N)
+    {
+        context.error_handler(doc_error{ input.location(), count < N ? doc_error::kind::too_few_elements : doc_error::kind::too_many_elements });
+        throw doc_consume_exception();
+    }
+}
+
+
+template<class T, class Input>
+std::vector<T> consume(type_wrap<std::vector<T>>, doc_input::token_kind first, Input &input, const doc_context &context)
 {
     if(first != doc_input::token_kind::begin_array && !input.hint(doc_input::token_kind::begin_array))
     {
@@ -85,20 +174,122 @@ std::vector<T> consume(type_wrap<std::vector<T>>, doc_input::token_kind first, d
     }
 
     std::vector<T> vector;
+    if(std::optional<size_t> count = input.element_count_hint())
+        vector.reserve(*count);
 
-    doc_input::token_kind token;
-    while((token = input.next_token()) != doc_input::token_kind::end_array)
+    doc_input::token_kind token = detail::read_number_elements<T>(input, [&]
+    {
+        vector.emplace_back(consume(type_wrap<T>(), doc_input::token_kind::number, input, context));
+    });
+
+    for(; token != doc_input::token_kind::end_array; token = input.next_token())
         vector.emplace_back(consume(type_wrap<T>(), token, input, context));
     
     return vector;
 }
 
+/// Reads the elements into the existing ones, so the vector and its elements keep their capacity, and removes the
+/// remaining ones.
+template<class T, class Input>
+void consume_into(std::vector<T> &vector, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    if constexpr(std::is_same_v<T, bool>) //elements cannot be referenced
+    {
+        vector = consume(type_wrap<std::vector<T>>(), first, input, context);
+    }
+    else
+    {
+        if(first != doc_input::token_kind::begin_array && !input.hint(doc_input::token_kind::begin_array))
+        {
+            context.error_handler(doc_error{ input.location(), doc_error::kind::type_mismatch });
+            throw doc_consume_exception();
+        }
+
+        if(std::optional<size_t> count = input.element_count_hint())
+            vector.reserve(*count);
+
+        size_t count = 0;
+        auto read_number = [&]
+        {
+            if(count < vector.size())
+                consume_existing(vector[count], doc_input::token_kind::number, input, context);
+            else
+                vector.emplace_back(consume(type_wrap<T>(), doc_input::token_kind::number, input, context));
+
+            count++;
+        };
+
+        doc_input::token_kind token = detail::read_number_elements<T>(input, read_number);
+        for(; token != doc_input::token_kind::end_array; token = input.next_token())
+        {
+            if(count < vector.size())
+                consume_existing(vector[count], token, input, context);
+            else
+                vector.emplace_back(consume(type_wrap<T>(), token, input, context));
+
+            count++;
+        }
+
+        vector.erase(vector.begin() + count, vector.end());
+    }
+}
 
-template<class K, class V>
-std::map<K, V> consume(type_wrap<std::map<K, V>>, doc_input::token_kind first, doc_input &input, const doc_context &context)
+
+namespace detail
 {
-    static_assert(std::is_constructible_v<K, ref_string&&>);
 
+/// Reads a mapping into an existing std::map or std::unordered_map. Values of keys which were already present are
+/// read into, nodes of other keys are reused for new keys, so neither nodes nor values are allocated again when
+/// documents repeat the same keys.
+template<class Map, class Input>
+void consume_mapping_into(Map &map, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    using key_type = typename Map::key_type;
+    using mapped_type = typename Map::mapped_type;
+
+    if(first != doc_input::token_kind::begin_mapping && !input.hint(doc_input::token_kind::begin_mapping))
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::type_mismatch });
+        throw doc_consume_exception();
+    }
+
+    Map previous;
+    previous.swap(map);
+
+    doc_input::token_kind token;
+    while((token = input.next_token()) != doc_input::token_kind::end_mapping)
+    {
+        key_type key = consume_key(type_wrap<key_type>(), input.mapping_key(), input, context);
+        if(auto duplicate = map.find(key); duplicate != map.end()) //the last value wins, like with consume()
+        {
+            consume_existing(duplicate->second, token, input, context);
+            continue;
+        }
+
+        auto node = previous.extract(key);
+        if(node.empty() && !previous.empty())
+        {
+            node = previous.extract(previous.begin());
+            node.key() = std::move(key);
+        }
+
+        if(node.empty())
+        {
+            map.emplace(std::move(key), consume(type_wrap<mapped_type>(), token, input, context));
+            continue;
+        }
+
+        consume_existing(node.mapped(), token, input, context);
+        map.insert(std::move(node));
+    }
+}
+
+} //end of detail
+
+
+template<class K, class V, class Input>
+std::map<K, V> consume(type_wrap<std::map<K, V>>, doc_input::token_kind first, Input &input, const doc_context &context)
+{
     if(first != doc_input::token_kind::begin_mapping && !input.hint(doc_input::token_kind::begin_mapping))
     {
         context.error_handler(doc_error{ input.location(), doc_error::kind::type_mismatch });
@@ -110,11 +301,47 @@ std::map<K, V> consume(type_wrap<std::map<K, V>>, doc_input::token_kind first, d
     doc_input::token_kind token;
     while((token = input.next_token()) != doc_input::token_kind::end_mapping)
     {
-        ref_string key = input.mapping_key();
-        map[K(std::move(key))] = consume(type_wrap<V>(), token, input, context);
+        K key = consume_key(type_wrap<K>(), input.mapping_key(), input, context);
+        map[std::move(key)] = consume(type_wrap<V>(), token, input, context);
     }
 
     return map;
 }
 
+template<class K, class V, class Input>
+void consume_into(std::map<K, V> &map, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    detail::consume_mapping_into(map, first, input, context);
+}
+
+
+template<class K, class V, class Input>
+std::unordered_map<K, V> consume(type_wrap<std::unordered_map<K, V>>, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    if(first != doc_input::token_kind::begin_mapping && !input.hint(doc_input::token_kind::begin_mapping))
+    {
+        context.error_handler(doc_error{ input.location(), doc_error::kind::type_mismatch });
+        throw doc_consume_exception();
+    }
+
+    std::unordered_map<K, V> map;
+    if(std::optional<size_t> count = input.element_count_hint())
+        map.reserve(*count);
+
+    doc_input::token_kind token;
+    while((token = input.next_token()) != doc_input::token_kind::end_mapping)
+    {
+        K key = consume_key(type_wrap<K>(), input.mapping_key(), input, context);
+        map[std::move(key)] = consume(type_wrap<V>(), token, input, context);
+    }
+
+    return map;
+}
+
+template<class K, class V, class Input>
+void consume_into(std::unordered_map<K, V> &map, doc_input::token_kind first, Input &input, const doc_context &context)
+{
+    detail::consume_mapping_into(map, first, input, context);
+}
+
 }
\ No newline at end of file
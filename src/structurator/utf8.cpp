@@ -54,6 +54,34 @@ void encode_utf8(std::string &str, char32_t cp)
 	}
 }
 
+char *encode_utf8(char *out, char32_t cp)
+{
+	if(cp < 0x80)
+	{
+		*out++ = (char)(unsigned char)cp;
+	}
+	else if(cp < 0x800)
+	{
+		*out++ = (char)(unsigned char)((cp >> 6) | 0xC0);
+		*out++ = (char)(unsigned char)((cp & 0x3F) | 0x80);
+	}
+	else if(cp < 0x10000)
+	{
+		*out++ = (char)(unsigned char)((cp >> 12) | 0xe0);
+		*out++ = (char)(unsigned char)(((cp >> 6) & 0x3F) | 0x80);
+		*out++ = (char)(unsigned char)((cp & 0x3f) | 0x80);
+	}
+	else
+	{
+		*out++ = (char)(unsigned char)((cp >> 18) | 0xF0);
+		*out++ = (char)(unsigned char)(((cp >> 12) & 0x3F) | 0x80);
+		*out++ = (char)(unsigned char)(((cp >> 6) & 0x3F) | 0x80);
+		*out++ = (char)(unsigned char)((cp & 0x3f) | 0x80);
+	}
+
+	return out;
+}
+
 
 size_t utf8_line_column(std::string_view str)
 {
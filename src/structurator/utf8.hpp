@@ -17,6 +17,10 @@ char32_t decode_utf8(std::string_view &str);
 /// Encodes the given code-point as UTF-8 and appends it to the given string.
 void encode_utf8(std::string &str, char32_t cp);
 
+/// Encodes the given code-point as UTF-8 into the buffer, which must have space for at least four code-units.
+/// Returns the end of the written code-units.
+char *encode_utf8(char *out, char32_t cp);
+
 /// Returns the number of glyphs since the last new-line or since the begin of the
 /// given UTF-8 string, starting at the end of the string.
 size_t utf8_line_column(std::string_view str);
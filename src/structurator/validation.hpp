@@ -50,8 +50,8 @@ private:
 };
 
 
-template<class T, class Validator>
-validated_type<T, Validator> consume(type_wrap<validated_type<T, Validator>>, doc_input::token_kind first, doc_input &input, const doc_context &context)
+template<class T, class Validator, class Input>
+validated_type<T, Validator> consume(type_wrap<validated_type<T, Validator>>, doc_input::token_kind first, Input &input, const doc_context &context)
 {
     T t = consume(type_wrap<T>(), first, input, context);
     std::optional<doc_error::kind> err = Validator()(t);
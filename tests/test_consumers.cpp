@@ -1,6 +1,9 @@
 #include <catch2/catch.hpp>
 
+#include <structurator/arena.hpp>
 #include <structurator/json_input.hpp>
+#include <structurator/owned_string.hpp>
+#include <structurator/interned_string.hpp>
 #include <structurator/native_consumers.hpp>
 #include <structurator/stdlib_consumers.hpp>
 
@@ -56,4 +59,190 @@ TEST_CASE("Native consumers")
         auto value = consume(stc::type_wrap<std::optional<int>>(), input->next_token(), *input, common_context);
         REQUIRE(!value.has_value());
     }
+    SECTION("Decoded numbers")
+    {
+        auto input = stc::json::input("[ 12345678, -9223372036854775808, 1.25e2, 123456789012345678901, 3e2, 1.5e-300 ]", [](const stc::json::parse_error &)
+        {
+            FAIL();
+        });
+
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::begin_array);
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::number);
+        REQUIRE(input->int64_value() == 12345678);
+        REQUIRE(input->uint64_value() == 12345678u);
+        REQUIRE(input->double_value() == 12345678.0);
+
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::number);
+        REQUIRE(input->int64_value() == INT64_MIN);
+        REQUIRE(!input->uint64_value());
+
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::number);
+        REQUIRE(!input->int64_value()); //has a fraction
+        REQUIRE(input->double_value() == 125.0);
+        REQUIRE(input->float_value() == 125.0f);
+
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::number);
+        REQUIRE(!input->uint64_value()); //too many digits, only available as raw number
+        REQUIRE(!input->double_value());
+        REQUIRE(std::string_view(input->raw_number()) == "123456789012345678901");
+
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::number);
+        REQUIRE(input->int64_value() == 300);
+
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::number);
+        REQUIRE(input->double_value() == 1.5e-300);
+        REQUIRE(!input->float_value()); //rounds to zero
+    }
+    SECTION("Numbers not decoded by the input")
+    {
+        auto read = [](std::string_view json, auto type, std::optional<stc::doc_error::kind> &error)
+        {
+            stc::doc_context context;
+            context.error_handler = [&](const stc::doc_error &err) { error = err.what; };
+
+            auto input = stc::json::input(json, [](const stc::json::parse_error &) { FAIL(); });
+            try
+            {
+                return consume(type, input->next_token(), *input, context);
+            }
+            catch(const stc::doc_consume_exception &)
+            {
+                return typename decltype(type)::type();
+            }
+        };
+
+        std::optional<stc::doc_error::kind> error;
+        REQUIRE(read("0.1", stc::type_wrap<double>(), error) == 0.1);
+        REQUIRE(read("9007199254740993", stc::type_wrap<double>(), error) == 9007199254740992.0);
+        REQUIRE(read("1.7976931348623157e308", stc::type_wrap<double>(), error) == 1.7976931348623157e308);
+        REQUIRE(read("18446744073709551615", stc::type_wrap<std::uint64_t>(), error) == UINT64_MAX);
+        REQUIRE(read("1.00000000000000011102230246251565404236316680908203125000000000000000001", stc::type_wrap<double>(), error) == 1.0000000000000002);
+        REQUIRE(read("1.00000000000000011102230246251565404236316680908203125", stc::type_wrap<double>(), error) == 1.0); //ties to even
+        REQUIRE(read("1e-45", stc::type_wrap<float>(), error) == std::numeric_limits<float>::denorm_min());
+        REQUIRE(read("0.1", stc::type_wrap<long double>(), error) == 0.1L);
+        REQUIRE(read("-0.0e-3000", stc::type_wrap<double>(), error) == 0.0);
+        REQUIRE(!error);
+
+        read("1.5", stc::type_wrap<int>(), error);
+        REQUIRE(error == stc::doc_error::kind::value_out_of_bounds);
+        read("300", stc::type_wrap<std::int8_t>(), error);
+        REQUIRE(error == stc::doc_error::kind::value_out_of_bounds);
+        read("-1", stc::type_wrap<unsigned>(), error);
+        REQUIRE(error == stc::doc_error::kind::value_too_small);
+        read("18446744073709551616", stc::type_wrap<std::uint64_t>(), error);
+        REQUIRE(error == stc::doc_error::kind::value_out_of_bounds);
+        read("1e400", stc::type_wrap<double>(), error);
+        REQUIRE(error == stc::doc_error::kind::value_out_of_bounds);
+        read("3.5e38", stc::type_wrap<float>(), error);
+        REQUIRE(error == stc::doc_error::kind::value_out_of_bounds);
+        error.reset();
+        read("-2.5e-3000", stc::type_wrap<double>(), error); //rounds to zero
+        REQUIRE(error == stc::doc_error::kind::value_out_of_bounds);
+    }
+
+    SECTION("Reserved containers")
+    {
+        auto input = stc::json::input(R"({ "a": [1, 2, 3], "b": [], "c": [4] })", [](const stc::json::parse_error &) { FAIL(); });
+
+        auto value = consume(stc::type_wrap<std::unordered_map<std::string, std::vector<int>>>(), input->next_token(), *input, common_context);
+        REQUIRE(value.size() == 3);
+        REQUIRE(value.bucket_count() >= 3);
+        REQUIRE(value["a"] == std::vector<int>{ 1, 2, 3 });
+        REQUIRE(value["a"].capacity() == 3); //reserved exactly instead of grown
+        REQUIRE(value["b"].empty());
+        REQUIRE(value["c"] == std::vector<int>{ 4 });
+    }
+
+    SECTION("String views")
+    {
+        std::string source = R"([ "plain", "esc\"aped" ])";
+        auto parse_error = [](const stc::json::parse_error &) { FAIL(); };
+        stc::doc_error::kind error = stc::doc_error::kind::type_mismatch;
+        stc::doc_context context{ [&](const stc::doc_error &err) { error = err.what; }, true };
+
+        stc::arena strings;
+        auto input = stc::json::input(source, parse_error, stc::json::input_options{ false, false, &strings });
+        auto views = consume(stc::type_wrap<std::vector<std::string_view>>(), input->next_token(), *input, context);
+        REQUIRE(views == std::vector<std::string_view>{ "plain", "esc\"aped" });
+        REQUIRE(views[0].data() == source.data() + 3); //references the source
+        REQUIRE(strings.used() > 0); //the unescaped string was placed in the arena
+
+        std::string writable = source;
+        input = stc::json::input_mutable(writable.data(), writable.size(), parse_error);
+        views = consume(stc::type_wrap<std::vector<std::string_view>>(), input->next_token(), *input, context);
+        REQUIRE(views == std::vector<std::string_view>{ "plain", "esc\"aped" });
+        REQUIRE(views[1].data() == writable.data() + 12); //unescaped in place
+
+        input = stc::json::input(source, parse_error); //unescaped strings are released with their ref_string
+        REQUIRE_THROWS_AS(consume(stc::type_wrap<std::vector<std::string_view>>(), input->next_token(), *input, context), stc::doc_consume_exception);
+        REQUIRE(error == stc::doc_error::kind::value_not_referenceable);
+
+        error = stc::doc_error::kind::type_mismatch;
+        context.document_outlives_values = false;
+        input = stc::json::input(source, parse_error, stc::json::input_options{ false, false, &strings });
+        REQUIRE_THROWS_AS(consume(stc::type_wrap<std::vector<std::string_view>>(), input->next_token(), *input, context), stc::doc_consume_exception);
+        REQUIRE(error == stc::doc_error::kind::value_not_referenceable);
+    }
+
+    SECTION("Owned strings")
+    {
+        auto input = stc::json::input(R"([ "plain", "escaped, as it \"is\" quoted", "" ])", [](const stc::json::parse_error &) { FAIL(); });
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::begin_array);
+
+        auto plain = consume(stc::type_wrap<stc::owned_string>(), input->next_token(), *input, common_context);
+        REQUIRE(std::string_view(plain) == "plain");
+
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::string);
+        stc::ref_string &&unescaped = input->string();
+        const char *buffer = unescaped.data();
+        auto adopted = stc::owned_string::adopt(std::move(unescaped));
+        REQUIRE(std::string_view(adopted) == "escaped, as it \"is\" quoted");
+        REQUIRE(adopted.data() == buffer); //taken over without copying, as it is too long to be stored inline
+
+        auto empty = consume(stc::type_wrap<stc::owned_string>(), input->next_token(), *input, common_context);
+        REQUIRE((empty.empty() && empty.data() == nullptr));
+
+        stc::owned_string copy = adopted;
+        stc::owned_string moved = std::move(adopted);
+        REQUIRE((copy == moved && copy.data() != buffer && moved.data() == buffer && adopted.empty()));
+        REQUIRE(copy < plain);
+    }
+
+    SECTION("Interned strings")
+    {
+        stc::string_pool pool;
+        stc::doc_context context{ [](const stc::doc_error &) { FAIL(); }, false, &pool };
+
+        auto input = stc::json::input(R"([ "alpha", "beta", "al\u0070ha", "" ])", [](const stc::json::parse_error &) { FAIL(); });
+        auto values = consume(stc::type_wrap<std::vector<stc::interned_string>>(), input->next_token(), *input, context);
+        REQUIRE(values.size() == 4);
+        REQUIRE((std::string_view(values[0]) == "alpha" && std::string_view(values[1]) == "beta"));
+        REQUIRE((values[0] == values[2] && values[0].data() == values[2].data() && values[0] != values[1]));
+        REQUIRE((values[3].empty() && values[3] == stc::interned_string()));
+        REQUIRE(pool.size() == 2);
+
+        input = stc::json::input(R"({ "beta": "alpha", "gamma": "beta" })", [](const stc::json::parse_error &) { FAIL(); });
+        auto map = consume(stc::type_wrap<std::map<stc::interned_string, stc::interned_string>>(), input->next_token(), *input, context);
+        REQUIRE(map.size() == 2);
+        REQUIRE(map.begin()->first == values[1]); //keys are interned into the same pool and ordered by content
+        REQUIRE(map.begin()->second == values[0]);
+        REQUIRE(std::string_view(std::next(map.begin())->first) == "gamma");
+        REQUIRE(pool.size() == 3);
+
+        input = stc::json::input(R"({ "gamma": 1, "alpha": 2 })", [](const stc::json::parse_error &) { FAIL(); });
+        auto counts = consume(stc::type_wrap<std::unordered_map<stc::interned_string, int>>(), input->next_token(), *input, context);
+        REQUIRE((counts.size() == 2 && counts[values[0]] == 2 && counts[std::next(map.begin())->first] == 1));
+        REQUIRE(pool.size() == 3);
+
+        stc::doc_error::kind error = stc::doc_error::kind::type_mismatch;
+        stc::doc_context no_pool{ [&](const stc::doc_error &err) { error = err.what; } };
+        input = stc::json::input(R"([ "alpha" ])", [](const stc::json::parse_error &) { FAIL(); });
+        REQUIRE_THROWS_AS(consume(stc::type_wrap<std::vector<stc::interned_string>>(), input->next_token(), *input, no_pool), stc::doc_consume_exception);
+        REQUIRE(error == stc::doc_error::kind::storage_missing);
+
+        error = stc::doc_error::kind::type_mismatch;
+        input = stc::json::input(R"({ "alpha": 1 })", [](const stc::json::parse_error &) { FAIL(); });
+        REQUIRE_THROWS_AS(consume(stc::type_wrap<std::map<stc::interned_string, int>>(), input->next_token(), *input, no_pool), stc::doc_consume_exception);
+        REQUIRE(error == stc::doc_error::kind::storage_missing);
+    }
 }
\ No newline at end of file
@@ -1,5 +1,14 @@
 #include <catch2/catch.hpp>
 
+#define STC_DEFINE_MESSAGES
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <optional>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
 #include <structurator/json_input.hpp>
 #include "stringify_document.hpp"
 
@@ -90,6 +99,115 @@ TEST_CASE("JSON input")
 
         REQUIRE(errcount == 3);
     }
+    SECTION("Streaming input")
+    {
+        std::string sample = R"(
+        {
+            "n1" :123, "n2": 123.0e-3,
+            "string": "abc\"def\u00e9",
+            "bool": true, "null": null,
+            "array": [ {"a":432}, 555, [ ] ],
+            "long": ")" + std::string(100, 'x') + R"("
+        }
+        )";
+
+        auto plain = stc::json::input(sample, [](const stc::json::parse_error &) { FAIL(); });
+        std::string expected = stringify_document(*plain);
+
+        for(size_t chunk_size : { 1, 3, 16, 4096 })
+        {
+            std::istringstream stream(sample);
+            auto streamed = stc::json::input(stc::stream_reader(stream), [](const stc::json::parse_error &) { FAIL(); }, { chunk_size });
+            REQUIRE(stringify_document(*streamed) == expected);
+        }
+
+        std::istringstream invalid(R"([
+            { "a": 1 },
+            { "b" 2 }
+        ])");
+
+        std::vector<stc::json::parse_error> errors;
+        auto streamed = stc::json::input(stc::stream_reader(invalid), [&](const stc::json::parse_error &err) { errors.push_back(err); }, { 8 });
+        REQUIRE_THROWS_AS(stringify_document(*streamed), stc::doc_input_exception);
+        REQUIRE(errors.size() == 1);
+        REQUIRE(errors[0].what == stc::json::parse_error::kind::expected_colon);
+        REQUIRE(errors[0].location.line == 3);
+        REQUIRE(errors[0].location.byte == std::string_view(R"([
+            { "a": 1 },
+            { "b" )").size());
+
+        //recovering from an error skips the rest of the container without keeping it buffered
+        std::string large = "[\n { \"a\" 1, \"b\": [";
+        for(int i = 0; i < 20000; ++i)
+            large += (i % 100 == 0 ? "\n" : "") + std::to_string(i) + ", ";
+
+        large += "0] },\n { \"c\" 2 }\n]";
+        size_t chunk_size = 64, position = 0, reads = 0;
+        char *lowest = nullptr, *highest = nullptr;
+        auto reader = [&](char *buffer, size_t size)
+        {
+            if(++reads > 8) //the buffer may grow while the first tokens are read
+            {
+                lowest = std::min(lowest != nullptr ? lowest : buffer, buffer);
+                highest = std::max(highest, buffer + size);
+            }
+
+            size_t count = std::min(size, large.size() - position);
+            std::memcpy(buffer, large.data() + position, count);
+            position += count;
+            return count;
+        };
+
+        errors.clear();
+        auto skipping = stc::json::input(reader, [&](const stc::json::parse_error &err) { errors.push_back(err); }, { chunk_size });
+        REQUIRE_THROWS_AS(stringify_document(*skipping), stc::doc_input_exception);
+        REQUIRE(position == large.size());
+        REQUIRE(size_t(highest - lowest) <= 8 * chunk_size);
+        REQUIRE(errors.size() == 2);
+        REQUIRE(errors[1].what == stc::json::parse_error::kind::expected_colon);
+        REQUIRE(errors[1].location.line == 203);
+        REQUIRE(errors[1].location.byte == large.find("2 }"));
+    }
+    SECTION("Input from file")
+    {
+        auto path = (std::filesystem::temp_directory_path() / "structurator_test.json").string();
+        std::ofstream(path, std::ios::binary) << R"({ "a": [1, "two"] })";
+
+        auto input = stc::json::input_from_file(path, [](const stc::json::parse_error &) { FAIL(); });
+        REQUIRE(input != nullptr);
+        REQUIRE(stringify_document(*input) == "<map>'a'=<array>entry=1 entry='two'</array></map>");
+
+        auto file = stc::mapped_file::open(path);
+        stc::mapped_file &same = *file;
+        *file = std::move(same); //self-assignment keeps the mapping
+        REQUIRE(std::string_view(*file) == R"({ "a": [1, "two"] })");
+
+        std::ofstream(path, std::ios::binary | std::ios::trunc).flush();
+        auto empty = stc::mapped_file::open(path);
+        REQUIRE(empty.has_value());
+        REQUIRE(empty->size() == 0);
+
+        std::filesystem::remove(path);
+        REQUIRE(stc::json::input_from_file(path, [](const stc::json::parse_error &) { FAIL(); }) == nullptr);
+    }
+    SECTION("Lazy line tracking")
+    {
+        std::string sample = "[\n";
+        for(int i = 0; i < 200; ++i) //more new-lines than covered by a single entry of the new-line index
+            sample += "    { \"a\": 1 },\n\n";
+        sample += "    { \"b\" 2 },\n    { \"c\": \"end\n\" }\n]";
+
+        std::vector<unsigned> lines;
+        stc::json::input_options options;
+        options.lazy_lines = true;
+        auto input = stc::json::input(sample, [&](const stc::json::parse_error &err)
+        {
+            lines.push_back(err.location.line);
+        }, options);
+
+        REQUIRE_THROWS_AS(stringify_document(*input), stc::doc_input_exception);
+        REQUIRE(lines == std::vector<unsigned>{ 402, 403 });
+    }
     SECTION("String escape sequences")
     {
         auto input = stc::json::input(u8R"("abc \t \n\f \\ \z \U123 \U2191 \uD834\uDD1E")", [](const stc::json::parse_error &)
@@ -99,4 +217,263 @@ TEST_CASE("JSON input")
 
         REQUIRE(stringify_document(*input) == u8"'abc \t \n\f \\ \\z \\U123 \u2191 \U0001D11E'");
     }
-}
\ No newline at end of file
+    SECTION("Long strings with escape sequences")
+    {
+        std::string text(100, 'x');
+        std::string json = '"' + text + "\\n" + text + "\\uD834\\uDD1E" + text + "\\u00e9\"";
+
+        auto input = stc::json::input(json, [](const stc::json::parse_error &)
+        {
+            FAIL();
+        });
+
+        REQUIRE(stringify_document(*input) == '\'' + text + '\n' + text + u8"\U0001D11E" + text + u8"\u00e9'");
+    }
+    SECTION("Escaped quotes")
+    {
+        auto input = stc::json::input(R"(["a\"b\\", "\\\""])", [](const stc::json::parse_error &)
+        {
+            FAIL();
+        });
+
+        REQUIRE(stringify_document(*input) == "<array>entry='a\"b\\'entry='\\\"'</array>");
+    }
+    SECTION("Inline strings")
+    {
+        //the raw strings are 14 and 17 bytes long
+        auto input = stc::json::input(R"([ "short \"esc\" ", "not short \"esc\"" ])", [](const stc::json::parse_error &) { FAIL(); });
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::begin_array);
+
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::string);
+        stc::ref_string short_string = input->string();
+        REQUIRE((short_string.is_inline() && short_string.is_owned() && !short_string.is_allocated()));
+        REQUIRE(std::string_view(short_string) == "short \"esc\" ");
+
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::string);
+        stc::ref_string long_string = input->string();
+        REQUIRE((long_string.is_allocated() && !long_string.is_inline()));
+        REQUIRE(std::string_view(long_string) == "not short \"esc\"");
+
+        stc::ref_string moved = std::move(short_string);
+        REQUIRE(std::string_view(moved) == "short \"esc\" ");
+        REQUIRE((moved.data() != short_string.data() && short_string.size() == 0 && !short_string.is_owned()));
+
+        const char *buffer = long_string.data();
+        std::unique_ptr<char[]> released = long_string.release();
+        REQUIRE((released.get() == buffer && long_string.size() == 0 && long_string.data() == nullptr));
+
+        stc::ref_string copy = stc::ref_string::make_copy("0123456789abcde");
+        REQUIRE((copy.is_inline() && copy.size() == stc::ref_string::inline_capacity && copy == stc::ref_string("0123456789abcde")));
+        REQUIRE(stc::ref_string::make_copy("0123456789abcdef").is_allocated());
+        REQUIRE(sizeof(stc::ref_string) == sizeof(const char*) + sizeof(size_t));
+    }
+    SECTION("Structural index")
+    {
+        std::string sample = "{\n";
+        for(int i = 0; i < 4000; ++i) //spans multiple index windows
+            sample += "    \"key" + std::to_string(i) + "\" : [ \"value\", \"esc\\\"aped\", 12.5e3, true, null ],\n";
+        sample += "    \"last\": {}\n}";
+
+        auto plain = stc::json::input(sample, [](const stc::json::parse_error &) { FAIL(); });
+        auto indexed = stc::json::input(sample, [](const stc::json::parse_error &) { FAIL(); }, { true });
+        REQUIRE(stringify_document(*indexed) == stringify_document(*plain));
+
+        std::string_view invalid = R"([
+            { "a": "no end quote,
+              "b": 1 },
+            { "c" 2 }
+        ])";
+
+        std::vector<stc::json::parse_error> plain_errors, indexed_errors;
+        auto plain_invalid = stc::json::input(invalid, [&](const stc::json::parse_error &err) { plain_errors.push_back(err); });
+        auto indexed_invalid = stc::json::input(invalid, [&](const stc::json::parse_error &err) { indexed_errors.push_back(err); }, { true });
+        REQUIRE_THROWS_AS(stringify_document(*plain_invalid), stc::doc_input_exception);
+        REQUIRE_THROWS_AS(stringify_document(*indexed_invalid), stc::doc_input_exception);
+
+        REQUIRE(plain_errors.size() == 2);
+        REQUIRE(indexed_errors.size() == plain_errors.size());
+        for(size_t i = 0; i < plain_errors.size(); ++i)
+        {
+            REQUIRE(indexed_errors[i].what == plain_errors[i].what);
+            REQUIRE(indexed_errors[i].location.byte == plain_errors[i].location.byte);
+            REQUIRE(indexed_errors[i].location.line == plain_errors[i].location.line);
+        }
+    }
+    SECTION("Skipping values")
+    {
+        std::string padding(100, ' ');
+        std::string sample = "[\n{ \"a\": \"x]\\\"}\", \"b\": [1, {\"c\": \"\\\\\"}, \"{[\"]" + padding + "\n},\n7, [" + padding +
+            "\"" + std::string(70, '\\') + "\", [[\n]], \"" + std::string(63, '\\') + "\"\"],\n8 ]";
+
+        auto check = [](stc::doc_input &input)
+        {
+            using token_kind = stc::doc_input::token_kind;
+
+            REQUIRE(input.next_token() == token_kind::begin_array);
+            REQUIRE(input.next_token() == token_kind::begin_mapping);
+            input.skip_value(token_kind::begin_mapping);
+
+            REQUIRE(input.next_token() == token_kind::number);
+            input.skip_value(token_kind::number);
+            REQUIRE(std::string_view(input.raw_number()) == "7");
+            REQUIRE(input.location().line == 4);
+
+            REQUIRE(input.next_token() == token_kind::begin_array);
+            input.skip_value(token_kind::begin_array);
+
+            REQUIRE(input.next_token() == token_kind::number);
+            REQUIRE(std::string_view(input.raw_number()) == "8");
+            REQUIRE(input.location().line == 6);
+            REQUIRE(input.next_token() == token_kind::end_array);
+            REQUIRE(input.next_token() == token_kind::eof);
+        };
+
+        auto plain = stc::json::input(sample, [](const stc::json::parse_error &) { FAIL(); });
+        check(*plain);
+
+        auto indexed = stc::json::input(sample, [](const stc::json::parse_error &) { FAIL(); }, { true });
+        check(*indexed);
+
+        for(size_t chunk_size : { 1, 3, 16, 4096 })
+        {
+            std::istringstream stream(sample);
+            auto streamed = stc::json::input(stc::stream_reader(stream), [](const stc::json::parse_error &) { FAIL(); }, { chunk_size });
+            check(*streamed);
+        }
+
+        std::vector<stc::json::parse_error> errors;
+        auto truncated = stc::json::input(R"([{ "a": [1, "]"] )", [&](const stc::json::parse_error &err) { errors.push_back(err); });
+        REQUIRE(truncated->next_token() == stc::doc_input::token_kind::begin_array);
+        REQUIRE(truncated->next_token() == stc::doc_input::token_kind::begin_mapping);
+        REQUIRE_THROWS_AS(truncated->skip_value(stc::doc_input::token_kind::begin_mapping), stc::doc_input_exception);
+        REQUIRE(!errors.empty());
+        REQUIRE(errors[0].what == stc::json::parse_error::kind::eof_unexpected);
+    }
+    SECTION("Arena for unescaped strings")
+    {
+        stc::arena strings(64);
+        stc::json::input_options options;
+        options.strings = &strings;
+
+        std::string_view sample = R"(["plain", "esc\"aped", { "k\u00e9y": "x" }])";
+        for(int i = 0; i < 3; ++i) //later documents reuse the blocks
+        {
+            auto input = stc::json::input(sample, [](const stc::json::parse_error &) { FAIL(); }, options);
+            REQUIRE(stringify_document(*input) == u8"<array>entry='plain'entry='esc\"aped'entry=<map>'k\u00e9y'='x'</map></array>");
+            REQUIRE(strings.used() == 17); //raw sizes of both escaped strings
+            REQUIRE(strings.capacity() == 64);
+            strings.reset();
+            REQUIRE(strings.used() == 0);
+        }
+
+        std::string long_string = "\"" + std::string(100, 'x') + "\\n\"";
+        std::istringstream stream(long_string);
+        auto streamed = stc::json::input(stc::stream_reader(stream), [](const stc::json::parse_error &) { FAIL(); }, { 16, &strings });
+        REQUIRE(streamed->next_token() == stc::doc_input::token_kind::string);
+        REQUIRE(std::string_view(streamed->string()) == std::string(100, 'x') + '\n');
+        REQUIRE(strings.capacity() == 64 + 128); //blocks double in size
+
+        auto *aligned = static_cast<char*>(strings.allocate(8, 8));
+        REQUIRE(reinterpret_cast<std::uintptr_t>(aligned) % 8 == 0);
+    }
+    SECTION("Unescaping in place")
+    {
+        std::string buffer = R"({ "k\"ey": [ "a\\b", "é\n", "plain" ] })";
+        auto input = stc::json::input_mutable(buffer.data(), buffer.size(), [](const stc::json::parse_error &) { FAIL(); });
+
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::begin_mapping);
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::begin_array);
+        stc::ref_string key = input->mapping_key();
+        REQUIRE(std::string_view(key) == "k\"ey");
+        REQUIRE(!key.is_allocated());
+        REQUIRE(key.data() == buffer.data() + 3);
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::string);
+        REQUIRE(std::string_view(input->string()) == "a\\b");
+        REQUIRE(input->next_token() == stc::doc_input::token_kind::string);
+        REQUIRE(std::string_view(input->string()) == u8"é\n");
+
+        //string with escape sequences before and behind the end of the first window of the structural index
+        std::string sample = "[\"x\\n" + std::string(70000, 'x') + "\\\"\", \"a\", [ \"b\" ]\n]";
+
+        auto plain = stc::json::input(sample, [](const stc::json::parse_error &) { FAIL(); });
+        std::string expected = stringify_document(*plain);
+
+        for(bool indexed : { false, true })
+        {
+            std::string copy = sample;
+            auto in_place = stc::json::input_mutable(copy.data(), copy.size(), [](const stc::json::parse_error &) { FAIL(); }, { indexed });
+            REQUIRE(stringify_document(*in_place) == expected);
+        }
+
+        //new-lines written by unescaping do not count as lines of the document
+        for(bool lazy : { false, true })
+        {
+            stc::json::input_options options;
+            options.lazy_lines = lazy;
+            std::string lines = "[\"a\\n\\n\\nb\",\n {\"x\" 1}]";
+            std::vector<stc::doc_location> locations;
+            auto in_place = stc::json::input_mutable(lines.data(), lines.size(), [&](const stc::json::parse_error &err) { locations.push_back(err.location); }, options);
+            REQUIRE(in_place->next_token() == stc::doc_input::token_kind::begin_array);
+            REQUIRE(in_place->next_token() == stc::doc_input::token_kind::string);
+            REQUIRE(std::string_view(in_place->string()) == "a\n\n\nb");
+            REQUIRE(in_place->next_token() == stc::doc_input::token_kind::begin_mapping);
+            REQUIRE(in_place->location().line == 2);
+            REQUIRE_THROWS_AS(in_place->next_token(), stc::doc_input_exception);
+            REQUIRE(locations.size() == 1);
+            REQUIRE(locations[0].line == 2);
+
+            lines = "[1,\n \"a\\n\\nb\"]";
+            in_place = stc::json::input_mutable(lines.data(), lines.size(), [](const stc::json::parse_error &) { FAIL(); }, options);
+            in_place->next_token();
+            in_place->next_token();
+            REQUIRE(in_place->next_token() == stc::doc_input::token_kind::string);
+            REQUIRE(std::string_view(in_place->string()) == "a\n\nb");
+            REQUIRE(in_place->location().line == 2);
+        }
+    }
+
+    SECTION("Element count hints")
+    {
+        std::string strings = "\"a,]\\\"}\", \"" + std::string(70, '\\') + "\", \"[\\\\\"";
+        std::string sample = "{ \"a\": [1, " + strings + ", [2, 3], {\"b\": 4, \"c\": [5, 6]}],\n \"e\": {}, \"f\": [ ], \"g\": [7," +
+            std::string(1100, ' ') + "8] }";
+
+        auto check = [](stc::doc_input &input)
+        {
+            using token_kind = stc::doc_input::token_kind;
+            std::vector<std::optional<size_t>> hints;
+            for(token_kind token; (token = input.next_token()) != token_kind::eof; )
+            {
+                if(token == token_kind::begin_array || token == token_kind::begin_mapping)
+                    hints.push_back(input.element_count_hint());
+                else if(token == token_kind::number)
+                    REQUIRE(!input.element_count_hint()); //only available right after the begin of a container
+            }
+
+            return hints;
+        };
+
+        //containers which extend beyond the lookahead are not counted
+        std::vector<std::optional<size_t>> expected = { std::nullopt, 6, 2, 2, 2, 0, 0, std::nullopt };
+        auto plain = stc::json::input(sample, [](const stc::json::parse_error &) { FAIL(); });
+        REQUIRE(check(*plain) == expected);
+
+        auto indexed = stc::json::input(sample, [](const stc::json::parse_error &) { FAIL(); }, { true });
+        REQUIRE(check(*indexed) == expected);
+
+        //the streaming parser only counts within the input it has already read
+        std::istringstream stream(sample);
+        auto streamed = stc::json::input(stc::stream_reader(stream), [](const stc::json::parse_error &) { FAIL(); }, { 16 });
+        std::vector<std::optional<size_t>> streamed_hints = check(*streamed);
+        REQUIRE(streamed_hints.size() == expected.size());
+        for(size_t i = 0; i < expected.size(); ++i)
+            REQUIRE((!streamed_hints[i] || streamed_hints[i] == expected[i]));
+    }
+
+    SECTION("Error messages")
+    {
+        using kind = stc::json::parse_error::kind;
+        for(unsigned what = 0; what <= unsigned(kind::expected_end); ++what)
+            REQUIRE(!stc::json::enum_string(kind(what)).empty());
+    }
+}
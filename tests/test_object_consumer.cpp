@@ -1,7 +1,15 @@
 #include <catch2/catch.hpp>
 
 #include <structurator/class_info.hpp>
+#include <structurator/arena_objects.hpp>
+#include <structurator/interned_string.hpp>
 #include <structurator/json_input.hpp>
+#include <structurator/soa_vector.hpp>
+#include <structurator/json_lines.hpp>
+#include <structurator/json_documents.hpp>
+#include <structurator/json_push.hpp>
+#include <structurator/json_parser.hpp>
+#include <structurator/json_parallel.hpp>
 #include <structurator/any_consumer.hpp>
 #include <structurator/object_mapper.hpp>
 #include <structurator/stdlib_consumers.hpp>
@@ -83,6 +91,253 @@ stc_declare_class(Complex,
 );
 
 
+/// Has the maximum number of members.
+struct Wide
+{
+    int m0 = 0;
+    int m1 = 0;
+    int m2 = 0;
+    int m3 = 0;
+    int m4 = 0;
+    int m5 = 0;
+    int m6 = 0;
+    int m7 = 0;
+    int m8 = 0;
+    int m9 = 0;
+    int m10 = 0;
+    int m11 = 0;
+    int m12 = 0;
+    int m13 = 0;
+    int m14 = 0;
+    int m15 = 0;
+    int m16 = 0;
+    int m17 = 0;
+    int m18 = 0;
+    int m19 = 0;
+    int m20 = 0;
+    int m21 = 0;
+    int m22 = 0;
+    int m23 = 0;
+    int m24 = 0;
+    int m25 = 0;
+    int m26 = 0;
+    int m27 = 0;
+    int m28 = 0;
+    int m29 = 0;
+    int m30 = 0;
+    int m31 = 0;
+    int m32 = 0;
+    int m33 = 0;
+    int m34 = 0;
+    int m35 = 0;
+    int m36 = 0;
+    int m37 = 0;
+    int m38 = 0;
+    int m39 = 0;
+    int m40 = 0;
+    int m41 = 0;
+    int m42 = 0;
+    int m43 = 0;
+    int m44 = 0;
+    int m45 = 0;
+    int m46 = 0;
+    int m47 = 0;
+    int m48 = 0;
+    int m49 = 0;
+    int m50 = 0;
+    int m51 = 0;
+    int m52 = 0;
+    int m53 = 0;
+    int m54 = 0;
+    int m55 = 0;
+    int m56 = 0;
+    int m57 = 0;
+    int m58 = 0;
+    int m59 = 0;
+    int m60 = 0;
+    int m61 = 0;
+    int m62 = 0;
+    int m63 = 0;
+
+    stc_declare_class(Wide,
+        m0,
+        m1,
+        m2,
+        m3,
+        m4,
+        (m5, stc::member_short("five")),
+        m6,
+        m7,
+        m8,
+        m9,
+        m10,
+        m11,
+        m12,
+        m13,
+        m14,
+        m15,
+        m16,
+        m17,
+        m18,
+        m19,
+        m20,
+        m21,
+        m22,
+        m23,
+        m24,
+        m25,
+        m26,
+        m27,
+        m28,
+        m29,
+        m30,
+        m31,
+        m32,
+        m33,
+        m34,
+        m35,
+        m36,
+        m37,
+        m38,
+        m39,
+        m40,
+        m41,
+        m42,
+        m43,
+        m44,
+        m45,
+        m46,
+        m47,
+        m48,
+        m49,
+        m50,
+        m51,
+        m52,
+        m53,
+        m54,
+        m55,
+        m56,
+        m57,
+        m58,
+        m59,
+        m60,
+        m61,
+        m62,
+        m63
+    );
+};
+
+
+/// Has a custom consume() function which takes the generic doc_input.
+struct Temperature
+{
+    double celsius = 0.0;
+};
+
+Temperature consume(stc::type_wrap<Temperature>, stc::doc_input::token_kind first, stc::doc_input &input, const stc::doc_context &context)
+{
+    return Temperature{ consume(stc::type_wrap<double>(), first, input, context) - 273.15 };
+}
+
+struct Measurement
+{
+    std::string station;
+    std::vector<Temperature> temperatures;
+    std::optional<B> extra;
+
+    stc_declare_class(Measurement, station, temperatures, (extra, stc::member_flag::maybe_default));
+};
+
+/// Only picks a few keys out of larger objects.
+struct Summary
+{
+    int id = 0;
+    std::vector<int> tags;
+
+    stc_declare_class_with(Summary, stc::class_flag::ignore_unknown_keys, id, (tags, stc::member_flag::first_of_multiple));
+};
+
+/// References its source and shares repeated strings.
+struct Request
+{
+    std::string_view path;
+    stc::interned_string host;
+
+    stc_declare_class(Request, path, host);
+};
+
+/// Is decoded repeatedly into the same object.
+struct Record
+{
+    std::string name;
+    std::vector<std::string> tags;
+    std::map<std::string, std::vector<int>> series;
+    int count = 5;
+    std::vector<int> parts;
+
+    stc_declare_class(Record, name, tags, series, (count, stc::member_flag::maybe_default), (parts, stc::member_flag::multiple));
+};
+
+/// Counts its live instances.
+struct Tracked
+{
+    static inline int alive = 0;
+
+    Tracked() { alive++; }
+    Tracked(const Tracked&) { alive++; }
+    ~Tracked() { alive--; }
+};
+
+struct Shape
+{
+    virtual ~Shape() = default;
+    virtual double area() const = 0;
+};
+
+struct Circle : Shape
+{
+    double radius = 0.0;
+    Tracked tracked;
+
+    double area() const override { return 3.0 * radius * radius; }
+
+    stc_declare_class(Circle, radius);
+};
+
+struct Rectangle : Shape
+{
+    double width = 0.0;
+    double height = 0.0;
+
+    double area() const override { return width * height; }
+
+    stc_declare_class(Rectangle, width, height);
+};
+
+/// Tree whose nodes are all placed in an arena.
+struct Layer
+{
+    stc::arena_string name;
+    stc::arena_ptr<Shape> shape;
+    stc::arena_vector<Layer> children;
+
+    stc_declare_class(Layer, name,
+        (shape, stc::member_alts("kind", stc::alt_mode::nest,
+            stc::alt<stc::arena_ptr<Circle>>("circle"), stc::alt<stc::arena_ptr<Rectangle>>("rectangle"))),
+        children);
+};
+
+/// Flat record which is read into columns.
+struct Sample
+{
+    std::string sensor;
+    double value = 0.0;
+    int quality = 3;
+
+    stc_declare_class(Sample, sensor, value, (quality, stc::member_flag::maybe_default | stc::member_flag::last_of_multiple));
+};
+
+
 TEST_CASE("Mapper")
 {
     SECTION("Class information")
@@ -175,4 +430,562 @@ TEST_CASE("Mapper")
         REQUIRE(std::get<1>(c->variant2).m1 == 1);
         REQUIRE(std::get<1>(c->variant2).m2 == 2);
     }
-}
+    SECTION("Class with many members")
+    {
+        std::string json = "{";
+        for(int i = 63; i >= 0; --i) //reverse order
+            json += (i == 63 ? "\"m" : ", \"m") + std::to_string(i) + "\": " + std::to_string(i * 2);
+
+        json.replace(json.find("\"m5\""), 4, "\"five\"");
+        json += "}";
+
+        auto fail_parse = [](const stc::json::parse_error&) { FAIL(); };
+        auto fail_consume = [](const stc::doc_error&) { FAIL(); };
+        std::optional<Wide> w = stc::json::from_json<Wide>(json, fail_parse, fail_consume);
+        REQUIRE(w.has_value());
+        REQUIRE(w->m0 == 0);
+        REQUIRE(w->m5 == 10);
+        REQUIRE(w->m17 == 34);
+        REQUIRE(w->m63 == 126);
+
+        std::vector<stc::doc_error::kind> errors;
+        auto collect = [&](const stc::doc_error &e) { errors.push_back(e.what); };
+        REQUIRE(!stc::json::from_json<Wide>(R"({ "m1": 1, "m64": 2 })", fail_parse, collect));
+        REQUIRE(!stc::json::from_json<Wide>(R"({ "m1": 1, "m1": 2 })", fail_parse, collect));
+        REQUIRE(!stc::json::from_json<Wide>(R"({ "m1": 1, "m5": 2 })", fail_parse, collect)); //only known by its short name
+        REQUIRE(!stc::json::from_json<Wide>(R"({ "m1": 1 })", fail_parse, collect));
+        REQUIRE(errors == std::vector<stc::doc_error::kind>{ stc::doc_error::kind::key_unknown, stc::doc_error::kind::key_duplicate,
+            stc::doc_error::kind::key_unknown, stc::doc_error::kind::key_missing });
+    }
+    SECTION("Key order prediction")
+    {
+        auto fail_parse = [](const stc::json::parse_error&) { FAIL(); };
+        auto fail_consume = [](const stc::doc_error&) { FAIL(); };
+
+        auto &stats = stc::get_key_order_stats<B>();
+        stats.hits = 0;
+        stats.misses = 0;
+
+        REQUIRE(stc::json::from_json<std::vector<B>>(R"([ { "m1": 1, "m2": 2 }, { "m1": 3, "m2": 4 } ])", fail_parse, fail_consume));
+        std::optional<B> b = stc::json::from_json<B>(R"({ "m2": 2, "m1": 1 })", fail_parse, fail_consume);
+        REQUIRE(b->m1 == 1);
+        REQUIRE(b->m2 == 2);
+
+#ifdef STC_KEY_ORDER_STATS
+        REQUIRE(stats.hits == 4);
+        REQUIRE(stats.misses == 2);
+#else
+        REQUIRE(stats.hits == 0); //nothing is counted unless enabled for the whole build
+        REQUIRE(stats.misses == 0);
+#endif
+    }
+    SECTION("Statically dispatched parser")
+    {
+        std::string_view sample = R"({ "station": "north", "temperatures": [ 273.15, 300.15 ], "extra": { "m1": 1, "m2": 2 } })";
+        auto fail_parse = [](const stc::json::parse_error&) { FAIL(); };
+        auto fail_consume = [](const stc::doc_error&) { FAIL(); };
+
+        std::optional<Measurement> m = stc::json::from_json<Measurement>(sample, fail_parse, fail_consume);
+        REQUIRE(m.has_value());
+        REQUIRE(m->station == "north");
+        REQUIRE(m->temperatures.size() == 2);
+        REQUIRE(m->temperatures[0].celsius == Approx(0.0));
+        REQUIRE(m->temperatures[1].celsius == Approx(27.0));
+        REQUIRE(m->extra->m2 == 2);
+
+        std::unique_ptr<stc::doc_input> input = stc::json::input(sample, fail_parse);
+        std::optional<Measurement> virtual_m = stc::from_input<Measurement>(*input, fail_consume);
+        REQUIRE(virtual_m.has_value());
+        REQUIRE(virtual_m->temperatures[1].celsius == m->temperatures[1].celsius);
+
+        size_t parse_errors = 0;
+        size_t consume_errors = 0;
+        auto count_parse = [&](const stc::json::parse_error&) { parse_errors++; };
+        auto count_consume = [&](const stc::doc_error&) { consume_errors++; };
+        REQUIRE(!stc::json::from_json<Measurement>(R"({ "station": "north", "temperatures": [ 1, ] })", count_parse, count_consume));
+        REQUIRE(!stc::json::from_json<Measurement>(R"({ "station": 5, "temperatures": [] })", count_parse, count_consume));
+        REQUIRE(parse_errors == 1);
+        REQUIRE(consume_errors == 1);
+    }
+    SECTION("Ignoring unknown keys")
+    {
+        std::string_view sample = R"({ "meta": { "name": "a \\\" } [", "list": [ { }, [ [ ] ] ] }, "id": 7,
+            "tags": [ 1, 2 ], "flag": true, "tags": [ 3 ], "more": [ "]" ] })";
+        auto fail_parse = [](const stc::json::parse_error&) { FAIL(); };
+        auto fail_consume = [](const stc::doc_error&) { FAIL(); };
+
+        std::optional<Summary> s = stc::json::from_json<Summary>(sample, fail_parse, fail_consume);
+        REQUIRE(s.has_value());
+        REQUIRE(s->id == 7);
+        REQUIRE(s->tags == std::vector<int>{ 1, 2 });
+
+        std::unique_ptr<stc::doc_input> input = stc::json::input(sample, fail_parse);
+        std::optional<Summary> virtual_s = stc::from_input<Summary>(*input, fail_consume);
+        REQUIRE(virtual_s.has_value());
+        REQUIRE(virtual_s->tags == s->tags);
+
+        std::vector<stc::doc_error::kind> errors;
+        auto collect = [&](const stc::doc_error &e) { errors.push_back(e.what); };
+        REQUIRE(!stc::json::from_json<Summary>(R"({ "id": 1, "id": 2, "tags": [] })", fail_parse, collect));
+        REQUIRE(!stc::json::from_json<Summary>(R"({ "unknown": [], "tags": [] })", fail_parse, collect));
+        REQUIRE(errors == std::vector<stc::doc_error::kind>{ stc::doc_error::kind::key_duplicate, stc::doc_error::kind::key_missing });
+    }
+    SECTION("Parallel arrays")
+    {
+        std::string sample = "[\n";
+        for(int i = 0; i < 6000; ++i) //enough for several parts
+        {
+            sample += (i == 0 ? "  { \"id\": " : ",\n  { \"id\": ") + std::to_string(i) +
+                R"(, "note": "a, ] \" [ {", "tags": [ )" + std::to_string(i % 7) + R"(, 1 ], "nested": { "x": [ [ ], { } ] } })";
+        }
+        sample += "\n]";
+
+        auto fail_parse = [](const stc::json::parse_error&) { FAIL(); };
+        auto fail_consume = [](const stc::doc_error&) { FAIL(); };
+        std::optional<std::vector<Summary>> serial = stc::json::from_json<std::vector<Summary>>(sample, fail_parse, fail_consume);
+        std::optional<std::vector<Summary>> parallel = stc::json::from_json_parallel<std::vector<Summary>>(sample, 4, fail_parse, fail_consume);
+        REQUIRE(parallel.has_value());
+        REQUIRE(parallel->size() == 6000);
+        REQUIRE(std::equal(parallel->begin(), parallel->end(), serial->begin(), [](const Summary &a, const Summary &b)
+        {
+            return a.id == b.id && a.tags == b.tags;
+        }));
+
+        //errors are reported like when reading serially, with the same locations
+        using error_list = std::vector<std::tuple<int, size_t, unsigned>>;
+        auto read = [](const std::string &json, auto from_json)
+        {
+            error_list errors;
+            auto parse_error = [&](const stc::json::parse_error &e) { errors.emplace_back(int(e.what), e.location.byte, e.location.line); };
+            auto consume_error = [&](const stc::doc_error &e) { errors.emplace_back(100 + int(e.what), e.location.byte, e.location.line); };
+            REQUIRE(!from_json(json, parse_error, consume_error));
+            return errors;
+        };
+
+        auto read_serial = [](const std::string &json, auto on_parse, auto on_consume)
+        {
+            return stc::json::from_json<std::vector<Summary>>(json, on_parse, on_consume);
+        };
+
+        auto read_parallel = [](const std::string &json, auto on_parse, auto on_consume)
+        {
+            return stc::json::from_json_parallel<std::vector<Summary>>(json, 4, on_parse, on_consume);
+        };
+
+        std::string invalid_syntax = sample;
+        invalid_syntax.replace(invalid_syntax.find("\"id\": 3000"), 10, "\"id\": 30 00");
+        error_list syntax_errors = read(invalid_syntax, read_serial);
+        REQUIRE(!syntax_errors.empty());
+        REQUIRE(read(invalid_syntax, read_parallel) == syntax_errors);
+
+        std::string invalid_type = sample;
+        invalid_type.replace(invalid_type.find("\"id\": 5000"), 10, "\"id\": \"5000\"");
+        error_list type_errors = read(invalid_type, read_serial);
+        REQUIRE(type_errors.size() == 1);
+        REQUIRE(std::get<2>(type_errors[0]) == 5002);
+        REQUIRE(read(invalid_type, read_parallel) == type_errors);
+
+        //parts are consumed with copies of the given context, or serially if it has a pool
+        std::string names = "[";
+        for(int i = 0; i < 20000; ++i)
+            names += (i == 0 ? "\"" : ", \"") + std::string(i % 2 == 0 ? "even" : "odd") + "\"";
+        names += "]";
+
+        stc::doc_context view_context{ fail_consume, true };
+        auto views = stc::json::from_json_parallel_with_context<std::vector<std::string_view>>(names, 4, fail_parse, view_context);
+        REQUIRE((views.has_value() && views->size() == 20000));
+        REQUIRE(((*views)[19999] == "odd" && (*views)[19999].data() > names.data() && (*views)[19999].data() < names.data() + names.size()));
+
+        stc::string_pool pool;
+        stc::doc_context pool_context{ fail_consume, false, &pool };
+        auto interned = stc::json::from_json_parallel_with_context<std::vector<stc::interned_string>>(names, 4, fail_parse, pool_context);
+        REQUIRE((interned.has_value() && interned->size() == 20000 && (*interned)[0] == (*interned)[2]));
+        REQUIRE(pool.size() == 2);
+    }
+
+    SECTION("JSON lines")
+    {
+        std::string sample;
+        for(int i = 0; i < 3000; ++i)
+            sample += R"({ "id": )" + std::to_string(i) + R"(, "tags": [ )" + std::to_string(i % 5) + " ] }" + (i % 3 == 0 ? "\r\n" : "\n");
+
+        sample.replace(sample.find(R"("id": 1000,)"), 11, R"("id": 10 00,)"); //line 1001 has a syntax error
+        sample.replace(sample.find(R"("id": 2000,)"), 11, R"("id": "x",)"); //line 2001 has a type error
+        sample.insert(sample.find(R"({ "id": 2500,)"), "\n  \t\n"); //blank lines shift the following ones
+
+        using error_list = std::vector<std::pair<int, unsigned>>;
+        using value_list = std::vector<std::pair<int, unsigned>>;
+        auto read = [&](stc::json::lines_options options, value_list &values)
+        {
+            error_list errors;
+            auto parse_error = [&](const stc::json::parse_error &e) { errors.emplace_back(int(e.what), e.location.line); };
+            auto consume_error = [&](const stc::doc_error &e) { errors.emplace_back(100 + int(e.what), e.location.line); };
+            bool tags_match = true;
+            auto on_value = [&](Summary &&s, unsigned line)
+            {
+                tags_match = tags_match && s.tags == std::vector<int>{ s.id % 5 };
+                values.emplace_back(s.id, line);
+            };
+
+            REQUIRE(stc::json::read_json_lines<Summary>(sample, on_value, parse_error, consume_error, options) == 2998);
+            REQUIRE(tags_match);
+            return errors;
+        };
+
+        //on the calling thread
+        stc::json::lines_options inline_options;
+        inline_options.threads = 1;
+        inline_options.batch_size = 1000;
+
+        value_list values;
+        error_list errors = read(inline_options, values);
+        REQUIRE(errors.size() == 2);
+        REQUIRE(errors[0].second == 1001);
+        REQUIRE(errors[1] == std::make_pair(100 + int(stc::doc_error::kind::type_mismatch), 2001u));
+
+        REQUIRE(values.size() == 2998);
+        REQUIRE(values[0] == std::make_pair(0, 1u));
+        REQUIRE(values[999] == std::make_pair(999, 1000u));
+        REQUIRE(values[1000] == std::make_pair(1001, 1002u));
+        REQUIRE(values.back() == std::make_pair(2999, 3002u));
+
+        //in order on several threads with few batches ahead
+        stc::json::lines_options ordered_options;
+        ordered_options.threads = 4;
+        ordered_options.batch_size = 500;
+        ordered_options.max_batches = 2;
+
+        value_list ordered_values;
+        REQUIRE(read(ordered_options, ordered_values) == errors);
+        REQUIRE(ordered_values == values);
+
+        //unordered, the values and errors of each batch stay together
+        stc::json::lines_options unordered_options = ordered_options;
+        unordered_options.ordered = false;
+
+        value_list unordered_values;
+        error_list unordered_errors = read(unordered_options, unordered_values);
+        std::sort(unordered_values.begin(), unordered_values.end());
+        std::sort(unordered_errors.begin(), unordered_errors.end(), [](const auto &a, const auto &b) { return a.second < b.second; });
+        REQUIRE(unordered_values == values);
+        REQUIRE(unordered_errors == errors);
+
+        //pulling values one by one
+        stc::json::lines_reader<Summary> reader("{ \"id\": 1, \"tags\": [ ] }\n\n{ \"id\": 2, \"tags\": [ ] }", [](const stc::json::parse_error&) { FAIL(); }, [](const stc::doc_error&) { FAIL(); });
+        std::optional<stc::json::line_value<Summary>> first = reader.next();
+        REQUIRE((first && first->value.id == 1 && first->line == 1));
+        std::optional<stc::json::line_value<Summary>> second = reader.next();
+        REQUIRE((second && second->value.id == 2 && second->line == 3));
+        REQUIRE(!reader.next());
+
+        //anything but whitespace after the value of a line is an error
+        std::vector<stc::json::parse_error> trailing;
+        stc::json::lines_reader<Summary> strict("{ \"id\": 1, \"tags\": [ ] } \r\n{ \"id\": 2, \"tags\": [ ] } {\"id\": 3}\n{ \"id\": 4, \"tags\": [ ] } x\n",
+            [&](const stc::json::parse_error &e) { trailing.push_back(e); }, [](const stc::doc_error&) { FAIL(); });
+        first = strict.next();
+        REQUIRE((first && first->value.id == 1 && first->line == 1));
+        REQUIRE(!strict.next());
+        REQUIRE(trailing.size() == 2);
+        REQUIRE(trailing[0].what == stc::json::parse_error::kind::expected_end);
+        REQUIRE((trailing[0].location.line == 2 && trailing[0].location.byte == 52));
+        REQUIRE((trailing[1].what == stc::json::parse_error::kind::expected_end && trailing[1].location.line == 3));
+
+        //members which need the context, read on the calling thread as the pool is not thread-safe
+        std::string requests;
+        for(int i = 0; i < 100; ++i)
+            requests += R"({ "path": "/)" + std::to_string(i) + R"(", "host": ")" + (i % 2 == 0 ? "a" : "b") + "\\u0031\" }\n";
+
+        stc::string_pool pool;
+        stc::json::lines_options context_options;
+        context_options.threads = 4;
+        context_options.batch_size = 100;
+        context_options.context.strings = &pool;
+
+        std::vector<Request> read_requests;
+        auto on_request = [&](Request &&r, unsigned) { read_requests.push_back(r); };
+        REQUIRE(stc::json::read_json_lines<Request>(requests, on_request, [](const stc::json::parse_error&) { FAIL(); }, [](const stc::doc_error&) { FAIL(); }, context_options) == 100);
+        REQUIRE((read_requests[0].path == "/0" && read_requests[99].path == "/99"));
+        REQUIRE((read_requests[0].path.data() >= requests.data() && read_requests[0].path.data() < requests.data() + requests.size()));
+        REQUIRE((std::string_view(read_requests[0].host) == "a1" && read_requests[0].host == read_requests[98].host));
+        REQUIRE(pool.size() == 2);
+    }
+
+    SECTION("Document streams")
+    {
+        std::string source = "{\"m1\":1,\"m2\":2}{\"m1\":3,\"m2\":4}\n"
+            "{ \"m1\": \"x\", \"m2\": [ \"]\" ] }  {\"m1\":5,\"m2\":6}\r\n"
+            "{\"m1\": 7 \"m2\": 8}\n"
+            "nope {\"m1\":9,\"m2\":10} [1] \n"
+            "{\"m1\":11,";
+
+        std::vector<std::pair<int, unsigned>> errors;
+        auto parse_error = [&](const stc::json::parse_error &e) { errors.emplace_back(int(e.what), e.location.line); };
+        auto consume_error = [&](const stc::doc_error &e) { errors.emplace_back(100 + int(e.what), e.location.line); };
+
+        stc::json::document_stream<B> stream(source, parse_error, consume_error);
+        std::vector<int> values;
+        for(std::optional<B> &document : stream)
+            values.push_back(document ? document->m1 * 100 + document->m2 : -1);
+
+        REQUIRE(values == std::vector<int>{ 102, 304, -1, 506, -1, -1, 910, -1, -1 });
+        REQUIRE(stream.offset() == source.size());
+
+        using kind = stc::json::parse_error::kind;
+        REQUIRE(errors.size() == 5);
+        REQUIRE(errors[0] == std::make_pair(100 + int(stc::doc_error::kind::type_mismatch), 2u));
+        REQUIRE(errors[1] == std::make_pair(int(kind::expected_separator), 3u));
+        REQUIRE(errors[2].second == 4u);
+        REQUIRE(errors[3] == std::make_pair(100 + int(stc::doc_error::kind::type_mismatch), 4u));
+        REQUIRE(errors[4] == std::make_pair(int(kind::eof_unexpected), 5u));
+
+        //lines are also tracked lazily and with the structural index
+        stc::json::input_options options;
+        options.lazy_lines = true;
+        options.structural_index = true;
+
+        std::vector<std::pair<int, unsigned>> first_errors = std::move(errors);
+        errors.clear();
+        stc::json::document_stream<B> lazy_stream(source, parse_error, consume_error, options);
+        REQUIRE(std::distance(lazy_stream.begin(), lazy_stream.end()) == 9);
+        REQUIRE(errors == first_errors);
+
+        stc::json::document_stream<B> empty_stream(" \n ", parse_error, consume_error);
+        REQUIRE(empty_stream.begin() == empty_stream.end());
+    }
+
+    SECTION("Push parser")
+    {
+        std::string source = "{\"m1\":1,\"m2\":2}{\"m\\u0031\":3,\"m2\":4}\n"
+            "  { \"m1\": \"x\\\"]\", \"m2\": [ \"]\" ] }\r\n"
+            "{\"m1\": 7 \"m2\": 8}\n"
+            "[1] {\"m1\":9,\"m2\":10}\n\n"
+            "{\"m1\":11,";
+
+        using error_list = std::vector<std::tuple<int, size_t, unsigned>>;
+        error_list errors;
+        std::vector<int> values;
+        auto parse_error = [&](const stc::json::parse_error &e) { errors.emplace_back(int(e.what), e.location.byte, e.location.line); };
+        auto consume_error = [&](const stc::doc_error &e) { errors.emplace_back(100 + int(e.what), e.location.byte, e.location.line); };
+        auto on_document = [&](std::optional<B> &&document) { values.push_back(document ? document->m1 * 100 + document->m2 : -1); };
+
+        //the same as reading the whole source at once
+        for(std::optional<B> &document : stc::json::document_stream<B>(source, parse_error, consume_error))
+            on_document(std::move(document));
+
+        std::vector<int> expected_values = std::move(values);
+        error_list expected_errors = std::move(errors);
+        REQUIRE(expected_values == std::vector<int>{ 102, 304, -1, -1, -1, 910, -1 });
+        REQUIRE(expected_errors.size() == 4);
+
+        stc::json::push_parser<B> push(on_document, parse_error, consume_error);
+        for(size_t split = 0; split <= source.size(); ++split) //two fragments split anywhere
+        {
+            values.clear();
+            errors.clear();
+            size_t count = push.feed(std::string_view(source).substr(0, split));
+            count += push.feed(std::string_view(source).substr(split));
+            size_t buffered = push.buffered();
+            count += push.finish();
+
+            REQUIRE((count == 7 && buffered == 9 && values == expected_values && errors == expected_errors));
+
+            for(auto &error : expected_errors) //locations continue in the next round
+            {
+                std::get<1>(error) += source.size();
+                std::get<2>(error) += 5;
+            }
+        }
+
+        stc::json::push_parser<B> bytewise(on_document, parse_error, consume_error);
+        values.clear();
+        for(size_t i = 0; i < source.size(); ++i)
+        {
+            bytewise.feed(std::string_view(source).substr(i, 1));
+            if(i == source.find("[1]") + 3) //documents are consumed as soon as they are complete
+                REQUIRE(values.size() == 5);
+        }
+
+        REQUIRE(values.size() == 6);
+        bytewise.finish();
+        REQUIRE(values == expected_values);
+        REQUIRE(bytewise.buffered() == 0);
+    }
+
+    SECTION("Decoding into existing objects")
+    {
+        size_t error_count = 0;
+        auto parse_error = [&](const stc::json::parse_error&) { error_count++; };
+        auto consume_error = [&](const stc::doc_error&) { error_count++; };
+
+        Record record;
+        REQUIRE(stc::json::from_json_into(record, R"({ "name": "a name which is not stored inline", "tags": [ "tag which is not stored inline", "second" ],
+            "series": { "a": [ 1, 2, 3 ], "b": [ 4, 5 ] }, "count": 7, "parts": 1, "parts": 2 })", parse_error, consume_error));
+
+        REQUIRE(record.name == "a name which is not stored inline");
+        REQUIRE(record.tags == std::vector<std::string>{ "tag which is not stored inline", "second" });
+        REQUIRE(record.series == std::map<std::string, std::vector<int>>{ { "a", { 1, 2, 3 } }, { "b", { 4, 5 } } });
+        REQUIRE(record.count == 7);
+        REQUIRE(record.parts == std::vector<int>{ 1, 2 });
+
+        const char *name_data = record.name.data();
+        const std::string *tags_data = record.tags.data();
+        const char *tag_data = record.tags[0].data();
+        const std::vector<int> *series_a = &record.series.at("a");
+        const int *series_a_data = series_a->data();
+        const std::vector<int> *series_b = &record.series.at("b");
+
+        REQUIRE(stc::json::from_json_into(record, R"({ "name": "other", "tags": [ "gamma" ], "series": { "a": [ 9 ], "c": [ 7, 7 ] }, "parts": 3 })",
+            parse_error, consume_error));
+
+        REQUIRE(record.name == "other");
+        REQUIRE(record.tags == std::vector<std::string>{ "gamma" });
+        REQUIRE(record.series == std::map<std::string, std::vector<int>>{ { "a", { 9 } }, { "c", { 7, 7 } } });
+        REQUIRE(record.count == 5); //missing members are reset to their defaults
+        REQUIRE(record.parts == std::vector<int>{ 3 });
+
+        //storage of the previous document is reused
+        REQUIRE(record.name.data() == name_data);
+        REQUIRE(record.tags.data() == tags_data);
+        REQUIRE(record.tags[0].data() == tag_data);
+        REQUIRE(&record.series.at("a") == series_a);
+        REQUIRE(record.series.at("a").data() == series_a_data);
+        REQUIRE(&record.series.at("c") == series_b); //node of a removed key is taken for a new one
+
+        REQUIRE(error_count == 0);
+        REQUIRE(!stc::json::from_json_into(record, " ", parse_error, consume_error));
+        REQUIRE(record.name == "other");
+        REQUIRE(!stc::json::from_json_into(record, R"({ "name": "x", "tags": 1 })", parse_error, consume_error));
+        REQUIRE(error_count == 1);
+
+        std::array<std::optional<std::unique_ptr<int>>, 2> nested;
+        REQUIRE(stc::json::from_json_into(nested, "[ 1, 2 ]", parse_error, consume_error));
+        const int *second = nested[1]->get();
+        REQUIRE(stc::json::from_json_into(nested, "[ null, 3 ]", parse_error, consume_error));
+        REQUIRE((!nested[0] && nested[1]->get() == second && *second == 3));
+    }
+
+    SECTION("Arena object graphs")
+    {
+        static_assert(std::is_trivially_destructible_v<Layer>);
+
+        std::string_view source = R"({ "name": "root", "kind": "circle", "shape": { "radius": 2 }, "children": [
+            { "name": "first", "kind": "rectangle", "shape": { "width": 2, "height": 3 }, "children": [ ] },
+            { "name": "second", "kind": "circle", "shape": { "radius": 1 }, "children": [ ] } ] })";
+
+        stc::arena storage;
+        stc::doc_context context{ [](const stc::doc_error &) { FAIL(); }, false, nullptr, &storage };
+        for(int i = 0; i < 2; ++i) //the second document reuses the memory of the first
+        {
+            auto root = stc::json::from_json_with_context<Layer>(source, [](const stc::json::parse_error &) { FAIL(); }, context);
+            REQUIRE(root.has_value());
+            REQUIRE((std::string_view(root->name) == "root" && root->shape->area() == 12.0));
+            REQUIRE(root->children.size() == 2);
+            REQUIRE((std::string_view(root->children[0].name) == "first" && root->children[0].shape->area() == 6.0));
+            REQUIRE((std::string_view(root->children[1].name) == "second" && root->children[1].shape->area() == 3.0));
+            REQUIRE((root->children[1].children.empty() && dynamic_cast<Circle*>(root->children[1].shape.get()) != nullptr));
+
+            REQUIRE(Tracked::alive == 2); //only the circles need to be destroyed
+            size_t used = storage.used();
+            size_t capacity = storage.capacity();
+            storage.reset();
+            REQUIRE(Tracked::alive == 0);
+            REQUIRE((used > 0 && storage.capacity() == capacity));
+        }
+
+        std::string numbers = "[";
+        for(int i = 0; i < 500; ++i) //too long to be counted ahead, so the capacity grows
+            numbers += (i == 0 ? "\"" : ", \"") + std::to_string(i) + " is a number which is not stored inline\"";
+
+        auto strings = stc::json::from_json_with_context<stc::arena_vector<std::string>>(numbers + "]", [](const stc::json::parse_error &) { FAIL(); }, context);
+        REQUIRE((strings.has_value() && strings->size() == 500));
+        REQUIRE(((*strings)[0] == "0 is a number which is not stored inline" && (*strings)[499] == "499 is a number which is not stored inline"));
+
+        stc::arena_ptr<Circle> circle = stc::make_arena_ptr<Circle>(storage);
+        stc::arena_ptr<Shape> shape = circle;
+        REQUIRE((shape.get() == circle.get() && Tracked::alive == 1));
+
+        std::vector<stc::doc_error::kind> errors;
+        stc::doc_context no_arena{ [&](const stc::doc_error &e) { errors.push_back(e.what); } };
+        REQUIRE(!stc::json::from_json_with_context<Layer>(source, [](const stc::json::parse_error &) { FAIL(); }, no_arena));
+        REQUIRE(!stc::json::from_json_with_context<stc::arena_vector<int>>("[ 1 ]", [](const stc::json::parse_error &) { FAIL(); }, no_arena));
+        REQUIRE(!stc::json::from_json_with_context<stc::arena_ptr<Circle>>(R"({ "radius": 1 })", [](const stc::json::parse_error &) { FAIL(); }, no_arena));
+        REQUIRE(errors == std::vector<stc::doc_error::kind>(3, stc::doc_error::kind::storage_missing));
+    }
+
+    SECTION("Struct of arrays")
+    {
+        auto parse_error = [](const stc::json::parse_error &) { FAIL(); };
+        int error_count = 0;
+        auto consume_error = [&](const stc::doc_error &e) { error_count++; REQUIRE(e.what == stc::doc_error::kind::key_missing); };
+
+        auto samples = stc::json::from_json<stc::soa_vector<Sample>>(R"([
+            { "sensor": "a", "value": 1.5, "quality": 1 },
+            { "value": 2.5, "sensor": "b" },
+            { "quality": 7, "sensor": "c", "value": -1, "quality": 9 } ])", parse_error, consume_error);
+
+        REQUIRE(samples.has_value());
+        REQUIRE(samples->size() == 3);
+        REQUIRE(samples->column(&Sample::value) == std::vector<double>{ 1.5, 2.5, -1.0 });
+        REQUIRE(samples->column<0>() == std::vector<std::string>{ "a", "b", "c" });
+        REQUIRE(samples->column(&Sample::quality) == std::vector<int>{ 1, 3, 9 }); //default and last of multiple
+
+        Sample second = (*samples)[1];
+        REQUIRE((second.sensor == "b" && second.value == 2.5 && second.quality == 3));
+        REQUIRE((*samples)[2][&Sample::sensor] == "c");
+
+        (*samples)[0] = Sample{ "z", 0.5, 2 };
+        samples->push_back(Sample{ "d", 4.0, 4 });
+        double sum = 0.0;
+        for(Sample sample : *samples)
+            sum += sample.value * sample.quality;
+
+        REQUIRE(sum == 0.5 * 2 + 2.5 * 3 - 1.0 * 9 + 4.0 * 4);
+        REQUIRE(samples->column<0>().back() == "d");
+
+        auto incomplete = stc::json::from_json<stc::soa_vector<Sample>>(R"([ { "sensor": "a", "value": 1 }, { "sensor": "b" } ])", parse_error, consume_error);
+        REQUIRE((!incomplete && error_count == 1));
+    }
+
+    SECTION("Number arrays")
+    {
+        //from_json() reads runs of numbers through json::parser::read_number_array(), json::input() through the
+        //generic one of doc_input, both must give the same values and errors at the same locations
+        auto read_both = [](std::string_view json, auto type)
+        {
+            using T = typename decltype(type)::type;
+            std::vector<std::string> errors[2];
+            auto parse_error = [&](int i) { return [&errors, i](const stc::json::parse_error &e) { errors[i].push_back("parse " + std::to_string(e.location.byte)); }; };
+            auto consume_error = [&](int i) { return [&errors, i](const stc::doc_error &e) { errors[i].push_back("consume " + std::to_string(e.location.byte)); }; };
+
+            std::optional<T> fast = stc::json::from_json<T>(json, parse_error(0), consume_error(0));
+            auto input = stc::json::input(json, parse_error(1));
+            std::optional<T> generic = stc::from_input<T>(*input, consume_error(1));
+            REQUIRE(fast == generic);
+            REQUIRE(errors[0] == errors[1]);
+            return std::make_pair(fast, errors[0]);
+        };
+
+        using ints = std::vector<int>;
+        REQUIRE(read_both("[1,-2 ,\n 3\t]", stc::type_wrap<ints>()).first == ints{ 1, -2, 3 });
+        REQUIRE(read_both("[ ]", stc::type_wrap<ints>()).first == ints{});
+        REQUIRE(read_both("[ [1, 2], [], [3e2] ]", stc::type_wrap<std::vector<ints>>()).first == std::vector<ints>{ { 1, 2 }, {}, { 300 } });
+        REQUIRE(read_both("[1.5, 2.25, 1e400]", stc::type_wrap<std::vector<double>>()).second == std::vector<std::string>{ "consume 12" });
+        REQUIRE(read_both("[0.5, -1, 3.5e38]", stc::type_wrap<std::array<float, 3>>()).second == std::vector<std::string>{ "consume 10" });
+        REQUIRE(read_both("[0.5, -1]", stc::type_wrap<std::array<float, 3>>()).second == std::vector<std::string>{ "consume 8" });
+        REQUIRE(read_both("[1, 2, \"3\"]", stc::type_wrap<ints>()).second == std::vector<std::string>{ "consume 7" });
+        REQUIRE(read_both("[1, 300, 3]", stc::type_wrap<std::vector<std::int8_t>>()).second == std::vector<std::string>{ "consume 4" });
+        REQUIRE(read_both("[1, null, 3]", stc::type_wrap<std::vector<std::optional<int>>>()).first == std::vector<std::optional<int>>{ 1, std::nullopt, 3 });
+
+        REQUIRE(read_both("[1 2]", stc::type_wrap<ints>()).second == std::vector<std::string>{ "parse 3" });
+        REQUIRE(read_both("[1, ]", stc::type_wrap<ints>()).second == std::vector<std::string>{ "parse 4" });
+        REQUIRE(read_both("[1, 2", stc::type_wrap<ints>()).second == std::vector<std::string>{ "parse 5" });
+
+        //the existing elements are overwritten and the remaining ones removed
+        auto fail_parse = [](const stc::json::parse_error&) { FAIL(); };
+        auto fail_consume = [](const stc::doc_error&) { FAIL(); };
+        ints target = { 9, 9, 9, 9 };
+        REQUIRE(stc::json::from_json_into(target, "[4, 5, 6]", fail_parse, fail_consume));
+        REQUIRE(target == ints{ 4, 5, 6 });
+        REQUIRE(stc::json::from_json_into(target, "[7, \"8\", 9]", fail_parse, [](const stc::doc_error &) {}) == false);
+    }
+}
\ No newline at end of file